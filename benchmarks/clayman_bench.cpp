@@ -0,0 +1,189 @@
+// Headless layout benchmark over synthetic scenarios, no renderer or font backend needed.
+// Build with -DCLAYMAN_BUILD_BENCHMARKS=ON, then run clayman_bench [frames] > results.json
+// Reports ns/element, ns/render command and heap allocations per frame as JSON, so runs can be diffed across releases.
+
+#include "../clayman.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+//Counts every operator new between frames, Clay itself allocates nothing after its arena is created
+static size_t allocationCount = 0;
+
+void* operator new(size_t size){
+    allocationCount++;
+    if(void* pointer = std::malloc(size ? size : 1)){
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+//Deterministic stub so results do not depend on a font backend
+static Clay_Dimensions benchMeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void*){
+    return (Clay_Dimensions){(float)text.length * config->fontSize * 0.5f, (float)config->fontSize};
+}
+
+static const char paragraphText[] =
+    "Layout engines spend most of their time sizing containers, wrapping words and positioning children. "
+    "This paragraph is long enough to wrap over several lines in a narrow column, so the text path measures, "
+    "caches and breaks words every frame just like a document view would.";
+
+static const Clay_String paragraph = {.length = (int32_t)(sizeof(paragraphText) - 1), .chars = paragraphText};
+static const Clay_String label = {.length = 5, .chars = "Label"};
+
+//Columns of nested padded containers, each level has a background so every element emits a command
+static void deepNesting(ClayMan& clayMan){
+    clayMan.element({.layout = {.sizing = clayMan.expandXY(), .childGap = 2}}, [&](){
+        for(int column = 0; column < 40; column++){
+            std::function<void(int)> nest = [&](int depth){
+                clayMan.element({
+                    .layout = {.sizing = clayMan.expandXY(), .padding = clayMan.padAll(1)},
+                    .backgroundColor = {(float)(depth * 2), 40, 60, 255}
+                }, [&](){
+                    if(depth < 60){
+                        nest(depth + 1);
+                    }
+                });
+            };
+            nest(0);
+        }
+    });
+}
+
+//Rows where every child grows to share the width
+static void wideGrowRows(ClayMan& clayMan){
+    clayMan.element({.layout = {.sizing = clayMan.expandXY(), .childGap = 1, .layoutDirection = CLAY_TOP_TO_BOTTOM}}, [&](){
+        for(int row = 0; row < 20; row++){
+            clayMan.element({.layout = {.sizing = clayMan.expandXY(), .childGap = 1}}, [&](){
+                for(int column = 0; column < 200; column++){
+                    clayMan.element({.layout = {.sizing = clayMan.expandXY()}, .backgroundColor = {80, (float)column, 120, 255}});
+                }
+            });
+        }
+    });
+}
+
+//A scrolling document of wrapped paragraphs in three columns
+static void textHeavy(ClayMan& clayMan){
+    clayMan.element({.layout = {.sizing = clayMan.expandXY(), .childGap = 16}, .scroll = {.vertical = true}}, [&](){
+        for(int column = 0; column < 3; column++){
+            clayMan.element({.layout = {.sizing = clayMan.expandX(), .childGap = 8, .layoutDirection = CLAY_TOP_TO_BOTTOM}}, [&](){
+                for(int i = 0; i < 60; i++){
+                    clayMan.textElement(paragraph, {.textColor = {230, 230, 230, 255}, .fontSize = 16});
+                }
+            });
+        }
+    });
+}
+
+//Tooltips and badges floating over a grid of cards
+static void floatingHeavy(ClayMan& clayMan){
+    clayMan.element({.layout = {.sizing = clayMan.expandXY(), .childGap = 4, .layoutDirection = CLAY_TOP_TO_BOTTOM}}, [&](){
+        for(int row = 0; row < 40; row++){
+            clayMan.element({.layout = {.sizing = clayMan.expandXY(), .childGap = 4}}, [&](){
+                for(int column = 0; column < 25; column++){
+                    clayMan.element({.layout = {.sizing = clayMan.expandXY()}, .backgroundColor = {50, 50, 70, 255}}, [&](){
+                        clayMan.element({
+                            .layout = {.sizing = clayMan.fixedSize(40, 16), .padding = clayMan.padAll(2)},
+                            .backgroundColor = {200, 60, 60, 255},
+                            .floating = {.offset = {4, -8}, .zIndex = (int16_t)(column % 8), .attachTo = CLAY_ATTACH_TO_PARENT}
+                        }, [&](){
+                            clayMan.textElement(label, {.textColor = {255, 255, 255, 255}, .fontSize = 10});
+                        });
+                    });
+                }
+            });
+        }
+    });
+}
+
+//A grid of small scrolling lists, like a dashboard of log panes
+static void manyScrollContainers(ClayMan& clayMan){
+    clayMan.element({.layout = {.sizing = clayMan.expandXY(), .childGap = 4, .layoutDirection = CLAY_TOP_TO_BOTTOM}}, [&](){
+        for(int row = 0; row < 20; row++){
+            clayMan.element({.layout = {.sizing = clayMan.expandXY(), .childGap = 4}}, [&](){
+                for(int column = 0; column < 20; column++){
+                    clayMan.element({
+                        .layout = {.sizing = clayMan.expandXY(), .childGap = 2, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+                        .backgroundColor = {30, 30, 40, 255},
+                        .scroll = {.vertical = true}
+                    }, [&](){
+                        for(int line = 0; line < 10; line++){
+                            clayMan.textElement(label, {.textColor = {200, 200, 200, 255}, .fontSize = 12});
+                        }
+                    });
+                }
+            });
+        }
+    });
+}
+
+struct Scenario {
+    const char* name;
+    void (*build)(ClayMan&);
+};
+
+int main(int argc, char** argv){
+    int frames = argc > 1 ? std::atoi(argv[1]) : 200;
+    if(frames < 1){
+        frames = 1;
+    }
+    const int warmupFrames = 5;
+
+    Clay_SetMaxElementCount(65536);
+    Clay_SetMaxScrollContainerCount(512);
+    ClayMan clayMan(1920, 1080, benchMeasureText, nullptr);
+
+    const Scenario scenarios[] = {
+        {"deep_nesting", deepNesting},
+        {"wide_grow_rows", wideGrowRows},
+        {"text_heavy", textHeavy},
+        {"floating_heavy", floatingHeavy},
+        {"many_scroll_containers", manyScrollContainers},
+    };
+
+    printf("{\n  \"benchmark\": \"clayman_bench\",\n  \"frames\": %d,\n  \"scenarios\": [\n", frames);
+    const size_t scenarioCount = sizeof(scenarios) / sizeof(scenarios[0]);
+    for(size_t s = 0; s < scenarioCount; s++){
+        const Scenario& scenario = scenarios[s];
+        long long totalNanoseconds = 0;
+        size_t totalAllocations = 0;
+        uint32_t elementCount = 0;
+        int32_t renderCommandCount = 0;
+        for(int frame = 0; frame < warmupFrames + frames; frame++){
+            clayMan.updateClayState(1920, 1080, 0, 0, 0, 0, 0.016f, false);
+            size_t allocationsBefore = allocationCount;
+            auto start = std::chrono::high_resolution_clock::now();
+            clayMan.beginLayout();
+            scenario.build(clayMan);
+            Clay_RenderCommandArray renderCommands = clayMan.endLayout();
+            auto end = std::chrono::high_resolution_clock::now();
+            if(frame < warmupFrames){
+                continue;
+            }
+            totalNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            totalAllocations += allocationCount - allocationsBefore;
+            elementCount = clayMan.getElementCount();
+            renderCommandCount = renderCommands.length;
+        }
+        double nsPerFrame = (double)totalNanoseconds / frames;
+        printf("    {\"name\": \"%s\", \"elements\": %u, \"renderCommands\": %d, \"nsPerFrame\": %.0f, "
+               "\"nsPerElement\": %.2f, \"nsPerRenderCommand\": %.2f, \"allocationsPerFrame\": %.2f}%s\n",
+            scenario.name, elementCount, renderCommandCount, nsPerFrame,
+            elementCount ? nsPerFrame / elementCount : 0.0,
+            renderCommandCount ? nsPerFrame / renderCommandCount : 0.0,
+            (double)totalAllocations / frames,
+            s + 1 < scenarioCount ? "," : "");
+    }
+    printf("  ]\n}\n");
+    return 0;
+}
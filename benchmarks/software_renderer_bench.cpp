@@ -0,0 +1,168 @@
+// Measures the software renderer on a card dashboard (rounded rects, borders, text, a scroll
+// container) at 1080p and 4K. Layout time is excluded, only rasterization is timed.
+// Build with -DCLAYMAN_BUILD_BENCHMARKS=ON, then run clayman_software_bench [frames] [threads] [out.ppm]
+// The optional PPM is the last 1080p frame, handy for eyeballing or golden-image diffs.
+// Then compares layout and rendering one after the other with the two-thread pipeline (submitFrame).
+
+#include "../clayman.hpp"
+#include "../include/software/clay_renderer_software.cpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <atomic>
+
+//Blocky stand-in glyphs for builds without FreeType, so the text path is still exercised
+static void makeBlockFont(Clay_SoftwareFont& font, int pixelSize){
+    font.pixelSize = pixelSize;
+    font.ascent = pixelSize * 0.8f;
+    font.lineHeight = pixelSize * 1.2f;
+    const int glyphWidth = pixelSize / 2;
+    const int glyphHeight = (int)(pixelSize * 0.7f);
+    font.atlasWidth = glyphWidth * 95;
+    font.atlasHeight = glyphHeight;
+    font.atlas.assign((size_t)font.atlasWidth * font.atlasHeight, 0);
+    for(int c = 0; c < 95; c++){
+        Clay_SoftwareGlyph& glyph = font.glyphs[c];
+        glyph = {c * glyphWidth, 0, c == 0 ? 0 : glyphWidth - 1, glyphHeight, 0.0f, -(float)glyphHeight, (float)glyphWidth};
+        for(int y = 0; y < glyphHeight; y++){
+            for(int x = 0; x < glyph.width; x++){
+                font.atlas[(size_t)y * font.atlasWidth + glyph.x + x] = ((x + y + c) % 3) ? 255 : 96;
+            }
+        }
+    }
+}
+
+static void buildDashboard(ClayMan& clayMan){
+    clayMan.element({
+        .id = clayMan.hashID("Root"),
+        .layout = {.sizing = clayMan.expandXY(), .padding = clayMan.padAll(16), .childGap = 16, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+        .backgroundColor = {30, 32, 40, 255}
+    }, [&](){
+        clayMan.element({
+            .layout = {.sizing = clayMan.expandXfixedY(56), .padding = clayMan.padX(16), .childAlignment = {.y = CLAY_ALIGN_Y_CENTER}},
+            .backgroundColor = {50, 54, 70, 255},
+            .cornerRadius = CLAY_CORNER_RADIUS(8)
+        }, [&](){
+            clayMan.textElement("Software renderer dashboard", {.textColor = {240, 240, 240, 255}, .fontSize = 24});
+        });
+        clayMan.element({
+            .id = clayMan.hashID("Cards"),
+            .layout = {.sizing = clayMan.expandXY(), .childGap = 12, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+            .scroll = {.vertical = true}
+        }, [&](){
+            for(int row = 0; row < 40; row++){
+                clayMan.element({.layout = {.sizing = clayMan.expandX(), .childGap = 12}}, [&](){
+                    for(int column = 0; column < 6; column++){
+                        clayMan.element({
+                            .layout = {.sizing = clayMan.expandXfixedY(120), .padding = clayMan.padAll(12), .childGap = 6, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+                            .backgroundColor = {(float)(60 + column * 20), 70, (float)(90 + row % 5 * 20), 230},
+                            .cornerRadius = CLAY_CORNER_RADIUS(12),
+                            .border = {.color = {200, 200, 220, 255}, .width = CLAY_BORDER_OUTSIDE(2)}
+                        }, [&](){
+                            clayMan.textElement("Card title", {.textColor = {255, 255, 255, 255}, .fontSize = 20});
+                            clayMan.textElement("Some detail text that wraps over a couple of lines inside the card", {.textColor = {210, 210, 220, 255}, .fontSize = 14});
+                        });
+                    }
+                });
+            }
+        });
+    });
+}
+
+static void writePpm(const char* path, const std::vector<uint32_t>& pixels, int width, int height){
+    FILE* file = fopen(path, "wb");
+    if(!file){
+        printf("could not write %s\n", path);
+        return;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    for(uint32_t pixel : pixels){
+        const unsigned char rgb[3] = {(unsigned char)pixel, (unsigned char)(pixel >> 8), (unsigned char)(pixel >> 16)};
+        fwrite(rgb, 1, 3, file);
+    }
+    fclose(file);
+}
+
+int main(int argc, char** argv){
+    int frames = argc > 1 ? std::atoi(argv[1]) : 60;
+    unsigned threads = argc > 2 ? (unsigned)std::atoi(argv[2]) : 0;
+    const char* ppmPath = argc > 3 ? argv[3] : nullptr;
+
+    Clay_SoftwareFont fonts[1];
+#if defined(CLAY_SOFTWARE_FREETYPE) && defined(CLAYMAN_BENCH_FONT)
+    if(!Clay_Software_LoadFont(&fonts[0], CLAYMAN_BENCH_FONT, 32)){
+        printf("could not load %s, using block glyphs\n", CLAYMAN_BENCH_FONT);
+        makeBlockFont(fonts[0], 32);
+    }
+#else
+    makeBlockFont(fonts[0], 32);
+#endif
+
+    ClayMan clayMan(1920, 1080, Clay_Software_MeasureText, fonts);
+    Clay_SoftwareRendererData rendererData(threads);
+    rendererData.fonts = fonts;
+    rendererData.clearColor = 0xFF101010;
+    printf("threads: %zu\n", rendererData.workers.size() + 1);
+
+    const int sizes[2][2] = {{1920, 1080}, {3840, 2160}};
+    for(const auto& size : sizes){
+        const int width = size[0], height = size[1];
+        std::vector<uint32_t> pixels((size_t)width * height);
+        clayMan.updateClayState(width, height, 0, 0, 0, 0, 0.016f, false);
+        clayMan.beginLayout();
+        buildDashboard(clayMan);
+        Clay_RenderCommandArray renderCommands = clayMan.endLayout();
+
+        long long totalMicroseconds = 0;
+        for(int frame = 0; frame < frames; frame++){
+            auto start = std::chrono::high_resolution_clock::now();
+            Clay_Software_RenderClayCommands(&rendererData, &renderCommands, {pixels.data(), width, height});
+            auto end = std::chrono::high_resolution_clock::now();
+            totalMicroseconds += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        }
+        printf("%dx%d: %d commands, %.2f ms/frame, %.1f frames/sec\n", width, height, renderCommands.length,
+            totalMicroseconds / 1000.0 / frames, frames * 1000000.0 / totalMicroseconds);
+        if(ppmPath && width == 1920){
+            writePpm(ppmPath, pixels, width, height);
+        }
+    }
+
+    //Layout is timed here too, a frame is everything from updateClayState() to the last pixel
+    const int width = 1920, height = 1080;
+    std::vector<uint32_t> pixels((size_t)width * height);
+    auto layoutFrame = [&](){
+        clayMan.updateClayState(width, height, 0, 0, 0, 0, 0.016f, false);
+        clayMan.beginLayout();
+        buildDashboard(clayMan);
+        return clayMan.endLayout();
+    };
+
+    auto serialStart = std::chrono::high_resolution_clock::now();
+    for(int frame = 0; frame < frames; frame++){
+        Clay_RenderCommandArray renderCommands = layoutFrame();
+        Clay_Software_RenderClayCommands(&rendererData, &renderCommands, {pixels.data(), width, height});
+    }
+    auto serialEnd = std::chrono::high_resolution_clock::now();
+
+    std::atomic<int> renderedFrames = 0;
+    auto pipelinedStart = std::chrono::high_resolution_clock::now();
+    clayMan.startRenderThread([&](Clay_RenderCommandArray renderCommands){
+        Clay_Software_RenderClayCommands(&rendererData, &renderCommands, {pixels.data(), width, height});
+        renderedFrames++;
+    });
+    for(int frame = 0; frame < frames; frame++){
+        clayMan.submitFrame(layoutFrame());
+    }
+    while(renderedFrames < frames){
+        std::this_thread::yield();
+    }
+    auto pipelinedEnd = std::chrono::high_resolution_clock::now();
+    clayMan.stopPipeline();
+
+    const double serialMilliseconds = std::chrono::duration<double, std::milli>(serialEnd - serialStart).count();
+    const double pipelinedMilliseconds = std::chrono::duration<double, std::milli>(pipelinedEnd - pipelinedStart).count();
+    printf("layout + render %dx%d: serial %.1f frames/sec, pipelined %.1f frames/sec\n", width, height,
+        frames * 1000.0 / serialMilliseconds, frames * 1000.0 / pipelinedMilliseconds);
+    return 0;
+}
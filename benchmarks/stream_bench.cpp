@@ -0,0 +1,233 @@
+// Throughput of the shared-memory render command stream (include/stream/clay_stream.cpp) against
+// sending the same encoded frames through a Unix socket. A forked child reads every frame it gets.
+// Build with -DCLAYMAN_BUILD_BENCHMARKS=ON, then run clayman_stream_bench [frames] > results.json
+
+#include "../clayman.hpp"
+#include "../include/stream/clay_stream.cpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+static Clay_Dimensions benchMeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void*){
+    return (Clay_Dimensions){(float)text.length * config->fontSize * 0.5f, (float)config->fontSize};
+}
+
+//A grid of cards with titles, wrapped detail text, borders and rounded corners
+static void buildCards(ClayMan& clayMan){
+    clayMan.element({.layout = {.sizing = clayMan.expandXY(), .padding = clayMan.padAll(16), .childGap = 12, .layoutDirection = CLAY_TOP_TO_BOTTOM}}, [&](){
+        for(int row = 0; row < 30; row++){
+            clayMan.element({.layout = {.sizing = clayMan.expandX(), .childGap = 12}}, [&](){
+                for(int column = 0; column < 6; column++){
+                    clayMan.element({
+                        .layout = {.sizing = clayMan.expandXfixedY(120), .padding = clayMan.padAll(12), .childGap = 6, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+                        .backgroundColor = {(float)(60 + column * 20), 70, (float)(90 + row % 5 * 20), 230},
+                        .cornerRadius = CLAY_CORNER_RADIUS(12),
+                        .border = {.color = {200, 200, 220, 255}, .width = CLAY_BORDER_OUTSIDE(2)}
+                    }, [&](){
+                        clayMan.textElement("Card title", {.textColor = {255, 255, 255, 255}, .fontSize = 20});
+                        clayMan.textElement("Some detail text that wraps over a couple of lines inside the card", {.textColor = {210, 210, 220, 255}, .fontSize = 14});
+                    });
+                }
+            });
+        }
+    });
+}
+
+//What the reading child sends back through a pipe
+struct ReaderResult {
+    uint64_t frames = 0;
+    uint64_t torn = 0;
+    uint64_t textBytes = 0;
+    long long nanoseconds = 0;
+};
+
+static bool readAll(int fd, void* data, size_t size){
+    uint8_t* bytes = (uint8_t*)data;
+    while(size > 0){
+        ssize_t count = read(fd, bytes, size);
+        if(count <= 0){
+            return false;
+        }
+        bytes += count;
+        size -= (size_t)count;
+    }
+    return true;
+}
+
+static bool writeAll(int fd, const void* data, size_t size){
+    const uint8_t* bytes = (const uint8_t*)data;
+    while(size > 0){
+        ssize_t count = write(fd, bytes, size);
+        if(count <= 0){
+            return false;
+        }
+        bytes += count;
+        size -= (size_t)count;
+    }
+    return true;
+}
+
+//Touches the text of every command, as a renderer would
+static uint64_t touchText(const Clay_RenderCommandArray& renderCommands){
+    uint64_t bytes = 0;
+    for(int32_t i = 0; i < renderCommands.length; i++){
+        const Clay_RenderCommand& command = renderCommands.internalArray[i];
+        if(command.commandType == CLAY_RENDER_COMMAND_TYPE_TEXT){
+            for(int32_t c = 0; c < command.renderData.text.stringContents.length; c++){
+                bytes += (uint8_t)command.renderData.text.stringContents.chars[c] != 0;
+            }
+        }
+    }
+    return bytes;
+}
+
+//Forks a reader running read(result) and returns its result once the writer is done
+template <typename Reader>
+static bool runChild(Reader read, pid_t& child, int& resultPipe){
+    int pipeFds[2];
+    if(pipe(pipeFds) != 0){
+        return false;
+    }
+    child = fork();
+    if(child < 0){
+        return false;
+    }
+    if(child == 0){
+        close(pipeFds[0]);
+        ReaderResult result;
+        read(result);
+        writeAll(pipeFds[1], &result, sizeof(result));
+        _exit(0);
+    }
+    close(pipeFds[1]);
+    resultPipe = pipeFds[0];
+    return true;
+}
+
+static ReaderResult finishChild(pid_t child, int resultPipe){
+    ReaderResult result;
+    readAll(resultPipe, &result, sizeof(result));
+    close(resultPipe);
+    waitpid(child, nullptr, 0);
+    return result;
+}
+
+int main(int argc, char** argv){
+    const int frames = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 2000;
+
+    ClayMan clayMan(1920, 1080, benchMeasureText, nullptr);
+    clayMan.updateClayState(1920, 1080, 0, 0, 0, 0, 0.016f, false);
+    clayMan.beginLayout();
+    buildCards(clayMan);
+    //Stays valid while nothing else is laid out, every frame streams the same commands
+    Clay_RenderCommandArray renderCommands = clayMan.endLayout();
+
+    size_t rawBytes = (size_t)renderCommands.length * sizeof(Clay_RenderCommand);
+    for(int32_t i = 0; i < renderCommands.length; i++){
+        if(renderCommands.internalArray[i].commandType == CLAY_RENDER_COMMAND_TYPE_TEXT){
+            rawBytes += renderCommands.internalArray[i].renderData.text.stringContents.length;
+        }
+    }
+
+    std::vector<uint8_t> encoded(rawBytes * 2 + 64);
+    uint32_t encodedBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int frame = 0; frame < frames; frame++){
+        encodedBytes = Clay_Stream_Encode(&renderCommands, encoded.data(), (uint32_t)encoded.size());
+    }
+    const double encodeNanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    std::vector<Clay_RenderCommand> decoded;
+    start = std::chrono::steady_clock::now();
+    for(int frame = 0; frame < frames; frame++){
+        Clay_Stream_Decode(encoded.data(), encodedBytes, decoded);
+    }
+    const double decodeNanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+
+    //Shared memory: the writer never waits, the reader takes the newest frame whenever it is ready
+    Clay_Stream stream;
+    if(!Clay_Stream_Create(&stream, nullptr, 4, encodedBytes + 64)){
+        printf("could not create the shared memory stream\n");
+        return 1;
+    }
+    const int sharedFd = stream.fd;
+    pid_t child;
+    int resultPipe;
+    runChild([&](ReaderResult& result){
+        Clay_Stream reader;
+        Clay_Stream_OpenFd(&reader, sharedFd);
+        auto readerStart = std::chrono::steady_clock::now();
+        for(;;){
+            Clay_Stream_WaitForFrame(&reader, 1000);
+            Clay_RenderCommandArray frame;
+            if(!Clay_Stream_ReadLatest(&reader, &frame)){
+                continue;
+            }
+            //An empty frame ends the run
+            if(frame.length == 0){
+                break;
+            }
+            result.textBytes += touchText(frame);
+            result.frames += Clay_Stream_FrameIntact(&reader);
+        }
+        result.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - readerStart).count();
+        result.torn = reader.tornFrames;
+    }, child, resultPipe);
+    start = std::chrono::steady_clock::now();
+    for(int frame = 0; frame < frames; frame++){
+        Clay_Stream_WriteFrame(&stream, &renderCommands);
+    }
+    const double sharedWriteNanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+    const Clay_RenderCommandArray endFrame = {};
+    Clay_Stream_WriteFrame(&stream, &endFrame);
+    const ReaderResult shared = finishChild(child, resultPipe);
+    Clay_Stream_Close(&stream);
+
+    //Socket: every frame is encoded, sent, received and decoded
+    int sockets[2];
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0){
+        printf("could not create a socket pair\n");
+        return 1;
+    }
+    runChild([&](ReaderResult& result){
+        close(sockets[0]);
+        std::vector<uint8_t> buffer;
+        std::vector<Clay_RenderCommand> commands;
+        auto readerStart = std::chrono::steady_clock::now();
+        uint32_t length;
+        while(readAll(sockets[1], &length, sizeof(length)) && length > 0){
+            buffer.resize(length);
+            readAll(sockets[1], buffer.data(), length);
+            Clay_Stream_Decode(buffer.data(), length, commands);
+            result.textBytes += touchText({(int32_t)commands.size(), (int32_t)commands.size(), commands.data()});
+            result.frames++;
+        }
+        result.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - readerStart).count();
+    }, child, resultPipe);
+    close(sockets[1]);
+    std::vector<uint8_t> message(encoded.size());
+    start = std::chrono::steady_clock::now();
+    for(int frame = 0; frame < frames; frame++){
+        const uint32_t length = Clay_Stream_Encode(&renderCommands, message.data(), (uint32_t)message.size());
+        writeAll(sockets[0], &length, sizeof(length));
+        writeAll(sockets[0], message.data(), length);
+    }
+    const double socketWriteNanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+    const uint32_t endLength = 0;
+    writeAll(sockets[0], &endLength, sizeof(endLength));
+    const ReaderResult socket = finishChild(child, resultPipe);
+    close(sockets[0]);
+
+    printf("{\n  \"benchmark\": \"clayman_stream_bench\",\n  \"frames\": %d,\n  \"renderCommands\": %d,\n", frames, renderCommands.length);
+    printf("  \"rawBytesPerFrame\": %zu,\n  \"encodedBytesPerFrame\": %u,\n", rawBytes, encodedBytes);
+    printf("  \"encodeNsPerFrame\": %.0f,\n  \"decodeNsPerFrame\": %.0f,\n", encodeNanoseconds, decodeNanoseconds);
+    printf("  \"sharedMemory\": {\"writeNsPerFrame\": %.0f, \"framesRead\": %llu, \"tornFrames\": %llu, \"readerNsPerFrame\": %.0f},\n",
+        sharedWriteNanoseconds, (unsigned long long)shared.frames, (unsigned long long)shared.torn,
+        shared.frames ? (double)shared.nanoseconds / shared.frames : 0.0);
+    printf("  \"socket\": {\"writeNsPerFrame\": %.0f, \"framesRead\": %llu, \"readerNsPerFrame\": %.0f}\n}\n",
+        socketWriteNanoseconds, (unsigned long long)socket.frames,
+        socket.frames ? (double)socket.nanoseconds / socket.frames : 0.0);
+    return 0;
+}
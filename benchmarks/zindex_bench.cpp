@@ -0,0 +1,60 @@
+// Measures layout time for a map-style screen with many floating markers at mixed zIndex values.
+// Build with -DCLAYMAN_BUILD_BENCHMARKS=ON, then run clayman_zindex_bench [floatingCount] [frames]
+
+#include "../clayman.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+//Deterministic stub so results do not depend on a font backend
+static Clay_Dimensions benchMeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void*){
+    return (Clay_Dimensions){(float)text.length * config->fontSize * 0.5f, (float)config->fontSize};
+}
+
+int main(int argc, char** argv){
+    int floatingCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 100;
+
+    //Every marker is an element, leave room for the root and the map container
+    Clay_SetMaxElementCount(floatingCount * 2 + 64);
+    ClayMan clayMan(1920, 1080, benchMeasureText, nullptr);
+
+    long long totalMicroseconds = 0;
+    long long worstMicroseconds = 0;
+    uint32_t renderCommandCount = 0;
+    for(int frame = 0; frame < frames; frame++){
+        clayMan.updateClayState(1920, 1080, 0, 0, 0, 0, 0.016f, false);
+        auto start = std::chrono::high_resolution_clock::now();
+        clayMan.beginLayout();
+        clayMan.element({.id = clayMan.hashID("Map"), .layout = {.sizing = clayMan.expandXY()}}, [&](){
+            uint32_t seed = 12345;
+            for(int i = 0; i < floatingCount; i++){
+                seed = seed * 1664525u + 1013904223u;
+                clayMan.element({
+                    .layout = {.sizing = clayMan.fixedSize(8, 8)},
+                    .backgroundColor = {200, 50, 50, 255},
+                    .floating = {
+                        .offset = {(float)(seed % 1920), (float)((seed >> 11) % 1080)},
+                        .zIndex = (int16_t)((seed >> 16) % 64),
+                        .attachTo = CLAY_ATTACH_TO_PARENT
+                    }
+                });
+            }
+        });
+        Clay_RenderCommandArray renderCommands = clayMan.endLayout();
+        auto end = std::chrono::high_resolution_clock::now();
+        long long microseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        totalMicroseconds += microseconds;
+        if(microseconds > worstMicroseconds){
+            worstMicroseconds = microseconds;
+        }
+        renderCommandCount = renderCommands.length;
+    }
+
+    printf("floating elements: %d\n", floatingCount);
+    printf("render commands:   %u\n", renderCommandCount);
+    printf("average layout:    %.1f us\n", (double)totalMicroseconds / frames);
+    printf("worst layout:      %lld us\n", worstMicroseconds);
+    return 0;
+}
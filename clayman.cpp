@@ -4,8 +4,105 @@
 #include "include/clay.h"
 #include "clayman.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <cstdio>
+
 static bool claymaninstancehasbeencreated = false;
 
+//The measure text function Clay called before beginLayout() wrapped it with ClayMan::measureTextHook()
+static Clay_Dimensions (*userMeasureText)(Clay_StringSlice text, Clay_TextElementConfig *config, void* userData) = nullptr;
+static uint64_t measureTextNanoseconds = 0;
+//Set while measure timing or layout analysis is enabled, the clock is only read then
+static bool measureTextTimed = false;
+
+//Hashes 8 bytes per step, a byte-wise hash over every render command costs more than the layout itself
+static uint64_t hashWords(uint64_t hash, const void* data, size_t size){
+    const uint8_t* bytes = (const uint8_t*)data;
+    for(size_t i = 0; i < size; i += 8){
+        uint64_t word = 0;
+        memcpy(&word, bytes + i, size - i < 8 ? size - i : 8);
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+template <typename T>
+static uint64_t hashValue(uint64_t hash, const T& value){
+    return hashWords(hash, &value, sizeof(value));
+}
+
+//The instance whose beginLayout() installed the hook
+static ClayMan* hookedClayMan = nullptr;
+
+//String ID of an element declared this frame, empty for generated IDs
+static std::string elementName(uint32_t elementId){
+    Clay_LayoutElementHashMapItem* item = Clay__GetHashMapItem(elementId);
+    if(!item || item == &Clay_LayoutElementHashMapItem_DEFAULT || !item->elementId.stringId.chars){
+        return std::string();
+    }
+    return std::string(item->elementId.stringId.chars, (size_t)item->elementId.stringId.length);
+}
+
+Clay_Dimensions ClayMan::measureTextHook(Clay_StringSlice text, Clay_TextElementConfig *config, void* userData){
+    Clay_Dimensions dimensions;
+    if(measureTextTimed){
+        auto measureStart = std::chrono::steady_clock::now();
+        dimensions = userMeasureText(text, config, userData);
+        measureTextNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - measureStart).count();
+    }else{
+        dimensions = userMeasureText(text, config, userData);
+    }
+    if(hookedClayMan && hookedClayMan->captureFile){
+        hookedClayMan->captureMeasurement(text, config, dimensions);
+    }
+    return dimensions;
+}
+
+#ifdef CLAY_TRACE
+//One slot of the trace ring buffer. sequence is the event's index + 1 once it is fully written, so a reader can skip slots that are being overwritten
+struct ClayManTraceEvent {
+    std::atomic<uint64_t> sequence;
+    std::atomic<const char*> name;
+    std::atomic<int64_t> nanoseconds;
+    std::atomic<uint32_t> threadId;
+    std::atomic<char> phase;
+};
+
+//Must be a power of two, older events are overwritten once it is full
+static constexpr size_t traceCapacity = 1 << 16;
+static ClayManTraceEvent traceEvents[traceCapacity];
+static std::atomic<uint64_t> traceWriteIndex{0};
+//Events before this index were dropped by clearTrace()
+static std::atomic<uint64_t> traceReadIndex{0};
+static std::atomic<uint32_t> traceThreadCount{0};
+static const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+
+//Wait-free, any thread may record while another one writes the trace out
+static void recordTraceEvent(const char* name, char phase){
+    static thread_local uint32_t threadId = ++traceThreadCount;
+    uint64_t index = traceWriteIndex.fetch_add(1, std::memory_order_relaxed);
+    ClayManTraceEvent& event = traceEvents[index & (traceCapacity - 1)];
+    event.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.nanoseconds.store(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceEpoch).count(), std::memory_order_relaxed);
+    event.threadId.store(threadId, std::memory_order_relaxed);
+    event.phase.store(phase, std::memory_order_relaxed);
+    event.sequence.store(index + 1, std::memory_order_release);
+}
+
+extern "C" void Clay__TraceBegin(const char* name){
+    recordTraceEvent(name, 'B');
+}
+
+extern "C" void Clay__TraceEnd(const char* name){
+    recordTraceEvent(name, 'E');
+}
+#endif
+
 ClayMan::ClayMan(
     const uint32_t initialWidth, 
     const uint32_t initialHeight, 
@@ -49,6 +146,13 @@ void ClayMan::updateClayState(
     const float frameTime, 
     const bool leftButtonDown
 ){
+    if(captureFile){
+        const float floats[6] = {mouseX, mouseY, scrollDeltaX, scrollDeltaY, frameTime, leftButtonDown ? 1.0f : 0.0f};
+        captureBuffer.push_back('U');
+        captureBytes(&width, sizeof(width));
+        captureBytes(&height, sizeof(height));
+        captureBytes(floats, sizeof(floats));
+    }
     windowWidth = width;
     windowHeight = height;
     if(windowWidth == 0){windowWidth = 1;}
@@ -63,24 +167,77 @@ void ClayMan::updateClayState(
         leftButtonDown
     );
 
+    rebuildHoveredIdSet();
+    dispatchEvents();
+
     Clay_UpdateScrollContainers(
         true,
         (Clay_Vector2) { scrollDeltaX, scrollDeltaY },
         frameTime
     );
+
+    //frameTime is left out, it changes every frame without changing anything on screen
+    const float inputs[5] = {(float)width, (float)height, mouseX, mouseY, leftButtonDown ? 1.0f : 0.0f};
+    uint64_t inputFingerprint = hashValue(14695981039346656037ull, inputs);
+    frameChanges.inputChanged = inputFingerprint != frameChanges.inputFingerprint || scrollDeltaX != 0 || scrollDeltaY != 0;
+    frameChanges.inputFingerprint = inputFingerprint;
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_PointerDataInteractionState pointerState = context->pointerInfo.state;
+    frameChanges.animationPending = pointerState == CLAY_POINTER_DATA_PRESSED_THIS_FRAME || pointerState == CLAY_POINTER_DATA_RELEASED_THIS_FRAME;
+    for(int32_t i = 0; i < context->scrollContainerDatas.length && !frameChanges.animationPending; i++){
+        const Clay_Vector2 momentum = context->scrollContainerDatas.internalArray[i].scrollMomentum;
+        frameChanges.animationPending = momentum.x != 0 || momentum.y != 0;
+    }
 }
 
 void ClayMan::beginLayout(){
+    //Spans the whole frame, closed at the end of endLayout()
+    CLAY__TRACE_BEGIN("ClayMan frame");
+    if(inputQueueEnabled){
+        CLAY__TRACE_BEGIN("ClayMan::drainInputQueue");
+        drainInputQueue();
+        CLAY__TRACE_END("ClayMan::drainInputQueue");
+    }
+    CLAY__TRACE_BEGIN("ClayMan::beginLayout");
     start = std::chrono::high_resolution_clock::now();
     countFrames();
     resetStringArenaIndex();
+    layerTag = nullptr;
+    layerTagScopes.clear();
+    //Wraps the measure function again whenever Clay_SetMeasureTextFunction() replaced it, the userData passes through unchanged
+    if(Clay__MeasureText && Clay__MeasureText != measureTextHook){
+        userMeasureText = Clay__MeasureText;
+        Clay__MeasureText = measureTextHook;
+    }
+    hookedClayMan = this;
+    if(captureFile){
+        captureBuffer.push_back('B');
+        if(captureScrollStatePending){
+            captureScrollState();
+        }
+    }
     Clay_BeginLayout();
+    CLAY__TRACE_END("ClayMan::beginLayout");
 }
 
 Clay_RenderCommandArray ClayMan::endLayout(){
+    CLAY__TRACE_BEGIN("ClayMan::endLayout");
     closeAllElements();
     measureTime();
-    return Clay_EndLayout();
+    Clay_RenderCommandArray renderCommands = Clay_EndLayout();
+    updateMemoryUsage();
+    if(idleDetectionEnabled){
+        fingerprintRenderCommands(renderCommands);
+    }
+    if(layoutAnalysisEnabled){
+        finishLayoutAnalysisFrame();
+    }
+    if(captureFile){
+        captureFrame(renderCommands);
+    }
+    CLAY__TRACE_END("ClayMan::endLayout");
+    CLAY__TRACE_END("ClayMan frame");
+    return renderCommands;
 }
 
 void ClayMan::element(){
@@ -120,11 +277,21 @@ void ClayMan::openElement(Clay_ElementDeclaration configs){
 }
 
 void ClayMan::openElement(){
+    if(captureFile){
+        captureBuffer.push_back('O');
+    }
     Clay__OpenElement();
     openElementCount++;
 }
 
 void ClayMan::closeElement(){
+    if(!layerTagScopes.empty() && layerTagScopes.back().depth == openElementCount){
+        layerTag = layerTagScopes.back().previousTag;
+        layerTagScopes.pop_back();
+    }
+    if(captureFile){
+        captureBuffer.push_back('X');
+    }
     Clay__CloseElement();
     if(openElementCount <=0){
         if(!warnedAboutUnderflow){
@@ -137,18 +304,65 @@ void ClayMan::closeElement(){
 }
 
 void ClayMan::textElement(const std::string& text, const Clay_TextElementConfig textElementConfig){
-    Clay_String cs = toClayString(text);
-    Clay__OpenTextElement(
-        cs, 
-        Clay__StoreTextElementConfig((Clay__Clay_TextElementConfigWrapper(textElementConfig)).wrapped)
-    );
+    textElement(toClayString(text), textElementConfig);
 }
 
 void ClayMan::textElement(const Clay_String& text, const Clay_TextElementConfig textElementConfig){
+    Clay_TextElementConfig config = textElementConfig;
+    if(layerTag != nullptr){
+        if(config.userData == nullptr){
+            config.userData = layerTag;
+        }else{
+            warnAboutLayerUserData();
+        }
+    }
+    if(captureFile){
+        captureBuffer.push_back('T');
+        captureString(text.chars, text.length);
+        captureBytes(&config, sizeof(config));
+    }
+    uint64_t missesBefore = layoutAnalysisEnabled ? Clay_GetCurrentContext()->measureTextCacheStats.misses : 0;
     Clay__OpenTextElement(
         text, 
-        Clay__StoreTextElementConfig((Clay__Clay_TextElementConfigWrapper(textElementConfig)).wrapped)
+        Clay__StoreTextElementConfig((Clay__Clay_TextElementConfigWrapper(config)).wrapped)
     );
+    if(layoutAnalysisEnabled){
+        uint64_t misses = Clay_GetCurrentContext()->measureTextCacheStats.misses - missesBefore;
+        if(misses > 0){
+            //The text element is already closed, so the open element is its parent
+            uint32_t parentId = Clay__GetOpenLayoutElement()->id;
+            TextMissAccumulator& accumulator = textMissAccumulators[parentId];
+            if(accumulator.hotspot.frames == 0){
+                accumulator.hotspot.parentId = parentId;
+                accumulator.hotspot.parentName = elementName(parentId);
+            }
+            if(accumulator.lastFrame != analyzedFrames){
+                accumulator.streak = accumulator.lastFrame + 1 == analyzedFrames ? accumulator.streak + 1 : 1;
+                accumulator.lastFrame = analyzedFrames;
+                accumulator.hotspot.frames++;
+                accumulator.hotspot.longestStreak = std::max(accumulator.hotspot.longestStreak, accumulator.streak);
+            }
+            accumulator.hotspot.misses += misses;
+        }
+    }
+}
+
+void ClayMan::layerElement(Clay_LayerConfig& layer, Clay_ElementDeclaration configs, std::function<void()> childLambda){
+    openElement();
+    if(layerTag == nullptr){
+        //A root with its own userData keeps it, its background and border are then drawn outside the cached texture
+        if(configs.userData == nullptr){
+            configs.userData = &layer;
+        }
+        configureOpenElement(configs);
+        pushLayerTag(&layer);
+    }else{
+        applyElementConfigs(configs);
+    }
+    if(childLambda != nullptr){
+        childLambda();
+    }
+    closeElement();
 }
 
 Clay_Sizing ClayMan::fixedSize(const uint32_t w, const uint32_t h) {
@@ -236,15 +450,68 @@ Clay_ElementId ClayMan::hashID(const std::string& id){
 }
 
 bool ClayMan::mousePressed(){
-    return Clay_GetCurrentContext()->pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME;
+    return queuedPressThisFrame || Clay_GetCurrentContext()->pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME;
+}
+
+bool ClayMan::idSetContains(const uint32_t* set, uint32_t id){
+    size_t mask = hoveredIdSetCapacity - 1;
+    for(size_t slot = id & mask; set[slot] != 0; slot = (slot + 1) & mask){
+        if(set[slot] == id){
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ClayMan::idSetInsert(uint32_t* set, uint32_t id){
+    size_t mask = hoveredIdSetCapacity - 1;
+    size_t slot = id & mask;
+    while(set[slot] != 0 && set[slot] != id){
+        slot = (slot + 1) & mask;
+    }
+    if(set[slot] != 0){
+        return false;
+    }
+    set[slot] = id;
+    return true;
+}
+
+bool ClayMan::pointerOver(const Clay_ElementId id){
+    if(hoveredIdSetOverflowed){
+        return Clay_PointerOver(id);
+    }
+    if(id.id == 0 || hoveredIdCount == 0){
+        return false;
+    }
+    return idSetContains(hoveredIdSet, id.id);
 }
 
 bool ClayMan::pointerOver(const Clay_String id){
-    return Clay_PointerOver(getClayElementId(id));
+    return pointerOver(getClayElementId(id));
 }
 
 bool ClayMan::pointerOver(const std::string& id){
-    return Clay_PointerOver(getClayElementId(toClayString(id)));
+    //Hashing only reads the chars, so there is no need to copy the ID into the string arena
+    return pointerOver(Clay_GetElementId((Clay_String){.length = (int32_t)id.size(), .chars = id.c_str()}));
+}
+
+void ClayMan::setEventHandlers(const Clay_ElementId id, const ClayManEventHandlers& handlers){
+    eventHandlers[id.id] = handlers;
+}
+
+void ClayMan::setEventHandlers(const std::string& id, const ClayManEventHandlers& handlers){
+    setEventHandlers(Clay_GetElementId((Clay_String){.length = (int32_t)id.size(), .chars = id.c_str()}), handlers);
+}
+
+void ClayMan::removeEventHandlers(const Clay_ElementId id){
+    eventHandlers.erase(id.id);
+}
+
+void ClayMan::clearEventHandlers(){
+    eventHandlers.clear();
+    previousHoveredIds.clear();
+    std::memset(previousHoveredIdSet, 0, sizeof(previousHoveredIdSet));
+    pressedIds.clear();
 }
 
 Clay_ElementId ClayMan::getClayElementId(const Clay_String id){
@@ -263,7 +530,261 @@ Clay_String ClayMan::toClayString(const std::string& str){
 }
 
 void ClayMan::applyElementConfigs(const Clay_ElementDeclaration& configs){
+    if(layerTag == nullptr){
+        configureOpenElement(configs);
+        return;
+    }
+    Clay_ElementDeclaration tagged = configs;
+    if(configs.floating.attachTo != CLAY_ATTACH_TO_NONE){
+        //Floating elements are drawn after the rest of the layout, so they cannot be part of the layer
+        pushLayerTag(nullptr);
+    }else if(tagged.userData == nullptr){
+        tagged.userData = layerTag;
+    }else{
+        warnAboutLayerUserData();
+    }
+    configureOpenElement(tagged);
+}
+
+void ClayMan::warnAboutLayerUserData(){
+    if(!warnedAboutLayerUserData){
+        printf("WARN: An element inside a layerElement has its own userData, which ends the cached part of the layer there.");
+        warnedAboutLayerUserData = true;
+    }
+}
+
+void ClayMan::configureOpenElement(const Clay_ElementDeclaration& configs){
+    if(captureFile){
+        captureBuffer.push_back('C');
+        captureBytes(&configs, sizeof(configs));
+        captureString(configs.id.stringId.chars, configs.id.stringId.length);
+    }
     Clay__ConfigureOpenElement((Clay__Clay_ElementDeclarationWrapper {configs}).wrapped);
+    if(layoutAnalysisEnabled && openElementCount > frameMaxDepth){
+        frameMaxDepth = openElementCount;
+        frameDeepestElementId = Clay__GetOpenLayoutElement()->id;
+    }
+}
+
+void ClayMan::rebuildHoveredIdSet(){
+    std::memset(hoveredIdSet, 0, sizeof(hoveredIdSet));
+    hoveredIdCount = 0;
+    hoveredIdSetOverflowed = false;
+
+    Clay__ElementIdArray& pointerOverIds = Clay_GetCurrentContext()->pointerOverIds;
+    //Keep the load factor at or below one half so probe chains stay short
+    if((size_t)pointerOverIds.length > hoveredIdSetCapacity / 2){
+        hoveredIdSetOverflowed = true;
+        return;
+    }
+
+    for(int32_t i = 0; i < pointerOverIds.length; i++){
+        uint32_t id = pointerOverIds.internalArray[i].id;
+        if(id != 0 && idSetInsert(hoveredIdSet, id)){
+            hoveredIdCount++;
+        }
+    }
+}
+
+bool ClayMan::wasHovered(const Clay_ElementId id){
+    if(!previousHoveredIdSetOverflowed){
+        return id.id != 0 && idSetContains(previousHoveredIdSet, id.id);
+    }
+    for(const Clay_ElementId& previous : previousHoveredIds){
+        if(previous.id == id.id){
+            return true;
+        }
+    }
+    return false;
+}
+
+void ClayMan::dispatchEvents(){
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_Vector2 position = context->pointerInfo.position;
+    Clay_Vector2 delta = {position.x - previousPointerPosition.x, position.y - previousPointerPosition.y};
+    previousPointerPosition = position;
+
+    if(eventHandlers.empty()){
+        if(!previousHoveredIds.empty()){
+            previousHoveredIds.clear();
+            std::memset(previousHoveredIdSet, 0, sizeof(previousHoveredIdSet));
+        }
+        pressedIds.clear();
+        return;
+    }
+
+    //Only IDs under the pointer this frame or last frame can produce events, so the cost does not grow with element count
+    for(const Clay_ElementId& id : previousHoveredIds){
+        if(!pointerOver(id)){
+            callEventHandler(id, &ClayManEventHandlers::onLeave);
+        }
+    }
+
+    Clay__ElementIdArray& pointerOverIds = context->pointerOverIds;
+    hoveredIds.clear();
+    for(int32_t i = 0; i < pointerOverIds.length; i++){
+        Clay_ElementId id = pointerOverIds.internalArray[i];
+        if(eventHandlers.find(id.id) == eventHandlers.end()){
+            continue;
+        }
+        hoveredIds.push_back(id);
+        if(!wasHovered(id)){
+            callEventHandler(id, &ClayManEventHandlers::onEnter);
+        }
+    }
+    previousHoveredIds.swap(hoveredIds);
+    std::memset(previousHoveredIdSet, 0, sizeof(previousHoveredIdSet));
+    previousHoveredIdSetOverflowed = previousHoveredIds.size() > hoveredIdSetCapacity / 2;
+    if(!previousHoveredIdSetOverflowed){
+        for(const Clay_ElementId& id : previousHoveredIds){
+            idSetInsert(previousHoveredIdSet, id.id);
+        }
+    }
+
+    switch(context->pointerInfo.state){
+        case CLAY_POINTER_DATA_PRESSED_THIS_FRAME: {
+            pressedIds = previousHoveredIds;
+            for(const Clay_ElementId& id : pressedIds){
+                callEventHandler(id, &ClayManEventHandlers::onPress);
+            }
+            break;
+        }
+        case CLAY_POINTER_DATA_PRESSED: {
+            if(delta.x != 0 || delta.y != 0){
+                for(const Clay_ElementId& id : pressedIds){
+                    callEventHandler(id, &ClayManEventHandlers::onDrag, delta);
+                }
+            }
+            break;
+        }
+        case CLAY_POINTER_DATA_RELEASED_THIS_FRAME: {
+            for(const Clay_ElementId& id : previousHoveredIds){
+                callEventHandler(id, &ClayManEventHandlers::onRelease);
+            }
+            //A click is a press and a release over the same element
+            for(const Clay_ElementId& id : pressedIds){
+                if(pointerOver(id)){
+                    callEventHandler(id, &ClayManEventHandlers::onClick);
+                }
+            }
+            pressedIds.clear();
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+ClayManInputQueue::ClayManInputQueue(size_t capacity){
+    size_t size = 2;
+    while(size < capacity){
+        size *= 2;
+    }
+    events.resize(size);
+    mask = size - 1;
+}
+
+bool ClayManInputQueue::push(const ClayManInputEvent& event){
+    const size_t position = tail.load(std::memory_order_relaxed);
+    if(position - head.load(std::memory_order_acquire) > mask){
+        return false;
+    }
+    events[position & mask] = event;
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool ClayManInputQueue::pop(ClayManInputEvent& event){
+    const size_t position = head.load(std::memory_order_relaxed);
+    if(position == tail.load(std::memory_order_acquire)){
+        return false;
+    }
+    event = events[position & mask];
+    head.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+void ClayMan::setIdleDetectionEnabled(bool enabled){
+    idleDetectionEnabled = enabled;
+    //The stored fingerprint may be from long ago, the first frame after a switch always counts as changed
+    frameChanges.visualChanged = true;
+    frameChanges.renderFingerprint = 0;
+}
+
+void ClayMan::setInputQueueEnabled(bool enabled){
+    inputQueueEnabled = enabled;
+    queuedPressThisFrame = false;
+    lastInputDrain = {};
+}
+
+bool ClayMan::pushInput(ClayManInputEvent event){
+    if(event.timestamp == 0){
+        event.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    return inputQueue.push(event);
+}
+
+void ClayMan::drainInputQueue(){
+    const auto now = std::chrono::steady_clock::now();
+    const float frameTime = lastInputDrain == std::chrono::steady_clock::time_point{} ? 0.0f : std::chrono::duration<float>(now - lastInputDrain).count();
+    lastInputDrain = now;
+    const uint64_t nowNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+
+    uint32_t width = windowWidth;
+    uint32_t height = windowHeight;
+    Clay_Vector2 scrollDelta = {};
+    Clay_Vector2 edgePosition = {};
+    bool edgeThisFrame = false;
+    queuedPressThisFrame = false;
+    inputLatencyMilliseconds = 0;
+
+    ClayManInputEvent event;
+    bool first = true;
+    while(inputQueue.pop(event)){
+        if(first){
+            inputLatencyMilliseconds = nowNanoseconds > event.timestamp ? (nowNanoseconds - event.timestamp) / 1e6 : 0;
+            first = false;
+        }
+        switch(event.type){
+            case ClayManInputType::POINTER_MOVE:
+                queuedPointerPosition = {event.x, event.y};
+                break;
+            case ClayManInputType::POINTER_DOWN:
+            case ClayManInputType::POINTER_UP: {
+                const bool down = event.type == ClayManInputType::POINTER_DOWN;
+                if(down == queuedPointerDown){
+                    queuedPointerPosition = {event.x, event.y};
+                    break;
+                }
+                //Only the last edge can go through updateClayState(), earlier ones are replayed at their own position now so quick clicks are not lost
+                if(edgeThisFrame){
+                    Clay_SetPointerState(edgePosition, queuedPointerDown);
+                    rebuildHoveredIdSet();
+                    dispatchEvents();
+                    queuedPressThisFrame = queuedPressThisFrame || queuedPointerDown;
+                }
+                edgePosition = {event.x, event.y};
+                queuedPointerPosition = edgePosition;
+                queuedPointerDown = down;
+                edgeThisFrame = true;
+                break;
+            }
+            case ClayManInputType::SCROLL:
+                scrollDelta.x += event.x;
+                scrollDelta.y += event.y;
+                break;
+            case ClayManInputType::RESIZE:
+                width = (uint32_t)event.x;
+                height = (uint32_t)event.y;
+                break;
+        }
+    }
+
+    updateClayState(width, height, queuedPointerPosition.x, queuedPointerPosition.y, scrollDelta.x, scrollDelta.y, frameTime, queuedPointerDown);
+    //A press and release in the same frame leave the pointer state as it was
+    if(edgeThisFrame){
+        frameChanges.inputChanged = true;
+    }
 }
 
 void ClayMan::closeAllElements(){
@@ -286,4 +807,1111 @@ int ClayMan::getWindowHeight(){
 
 uint32_t ClayMan::getFramecount(){
     return framecount;
-}
\ No newline at end of file
+}
+
+//Calls visit(name, sizedBy, array, tracksLength) for every arena-backed array of the context
+template<typename Visitor>
+static void visitContextArrays(Clay_Context* context, Visitor&& visit){
+    using enum ClayManCapacity;
+    //Hash buckets and treeNodeVisited are indexed directly, their length stays 0 or capacity
+    visit("layoutElements", ELEMENTS, context->layoutElements, true);
+    visit("renderCommands", ELEMENTS, context->renderCommands, true);
+    visit("openLayoutElementStack", ELEMENTS, context->openLayoutElementStack, true);
+    visit("layoutElementChildren", ELEMENTS, context->layoutElementChildren, true);
+    visit("layoutElementChildrenBuffer", ELEMENTS, context->layoutElementChildrenBuffer, true);
+    visit("textElementData", ELEMENTS, context->textElementData, true);
+    visit("imageElementPointers", ELEMENTS, context->imageElementPointers, true);
+    visit("reusableElementIndexBuffer", ELEMENTS, context->reusableElementIndexBuffer, true);
+    visit("layoutElementClipElementIds", ELEMENTS, context->layoutElementClipElementIds, true);
+    visit("layoutConfigs", ELEMENTS, context->layoutConfigs, true);
+    visit("elementConfigs", ELEMENTS, context->elementConfigs, true);
+    visit("textElementConfigs", ELEMENTS, context->textElementConfigs, true);
+    visit("imageElementConfigs", ELEMENTS, context->imageElementConfigs, true);
+    visit("floatingElementConfigs", ELEMENTS, context->floatingElementConfigs, true);
+    visit("scrollElementConfigs", ELEMENTS, context->scrollElementConfigs, true);
+    visit("customElementConfigs", ELEMENTS, context->customElementConfigs, true);
+    visit("borderElementConfigs", ELEMENTS, context->borderElementConfigs, true);
+    visit("sharedElementConfigs", ELEMENTS, context->sharedElementConfigs, true);
+    visit("layoutElementIdStrings", ELEMENTS, context->layoutElementIdStrings, true);
+    visit("wrappedTextLines", ELEMENTS, context->wrappedTextLines, true);
+    visit("layoutElementTreeNodeArray1", ELEMENTS, context->layoutElementTreeNodeArray1, true);
+    visit("layoutElementTreeRoots", ELEMENTS, context->layoutElementTreeRoots, true);
+    visit("layoutElementTreeRootsSortBuffer", ELEMENTS, context->layoutElementTreeRootsSortBuffer, true);
+    visit("layoutElementsHashMapInternal", ELEMENTS, context->layoutElementsHashMapInternal, true);
+    visit("layoutElementsHashMap", ELEMENTS, context->layoutElementsHashMap, false);
+    visit("measureTextHashMapInternal", ELEMENTS, context->measureTextHashMapInternal, true);
+    visit("measureTextHashMapInternalFreeList", ELEMENTS, context->measureTextHashMapInternalFreeList, true);
+    visit("measureTextHashMap", ELEMENTS, context->measureTextHashMap, false);
+    visit("measuredWords", MEASURE_TEXT_CACHE_WORDS, context->measuredWords, true);
+    visit("measuredWordsFreeList", MEASURE_TEXT_CACHE_WORDS, context->measuredWordsFreeList, true);
+    visit("openClipElementStack", ELEMENTS, context->openClipElementStack, true);
+    visit("pointerOverIds", ELEMENTS, context->pointerOverIds, true);
+    visit("scrollContainerDatas", SCROLL_CONTAINERS, context->scrollContainerDatas, true);
+    visit("scrollContainerHashMap", SCROLL_CONTAINERS, context->scrollContainerHashMap, false);
+    visit("treeNodeVisited", ELEMENTS, context->treeNodeVisited, false);
+    visit("dynamicStringData", ELEMENTS, context->dynamicStringData, true);
+    visit("debugElementData", ELEMENTS, context->debugElementData, true);
+    visit("warnings", FIXED, context->warnings, true);
+}
+
+ClayManMeasureTextStats ClayMan::getMeasureTextStats(){
+    ClayManMeasureTextStats stats;
+    stats.cache = Clay_GetMeasureTextCacheStats();
+    stats.measureMilliseconds = measureTextNanoseconds / 1000000.0;
+    return stats;
+}
+
+void ClayMan::setMeasureTextTimingEnabled(bool enabled){
+    measureTextTimingEnabled = enabled;
+    measureTextTimed = measureTextTimingEnabled || layoutAnalysisEnabled;
+}
+
+void ClayMan::resetMeasureTextStats(){
+    Clay_ResetMeasureTextCacheStats();
+    measureTextNanoseconds = 0;
+}
+
+void ClayMan::updateMemoryUsage(){
+    Clay_Context* context = Clay_GetCurrentContext();
+    if(!context){
+        return;
+    }
+    if(memoryUsage.empty()){
+        visitContextArrays(context, [&](const char* name, ClayManCapacity sizedBy, const auto& array, bool tracksLength){
+            ClayManArrayUsage usage;
+            usage.name = name;
+            usage.sizedBy = sizedBy;
+            usage.tracksLength = tracksLength;
+            usage.elementSize = sizeof(*array.internalArray);
+            memoryUsage.push_back(usage);
+        });
+    }
+    size_t index = 0;
+    visitContextArrays(context, [&](const char*, ClayManCapacity, const auto& array, bool){
+        ClayManArrayUsage& usage = memoryUsage[index++];
+        if(usage.tracksLength){
+            usage.length = array.length;
+            usage.peak = std::max(usage.peak, array.length);
+        }
+        usage.capacity = array.capacity;
+        usage.bytesReserved = (size_t)array.capacity * usage.elementSize;
+    });
+}
+
+const std::vector<ClayManArrayUsage>& ClayMan::getMemoryUsage(){
+    if(memoryUsage.empty()){
+        updateMemoryUsage();
+    }
+    return memoryUsage;
+}
+
+ClayManCapacities ClayMan::getRecommendedCapacities(float headroom){
+    ClayManCapacities capacities;
+    Clay_Context* context = Clay_GetCurrentContext();
+    if(!context){
+        return capacities;
+    }
+    if(headroom < 1.0f){
+        headroom = 1.0f;
+    }
+    int32_t elementPeak = 1, wordPeak = 1, scrollPeak = 1;
+    for(const ClayManArrayUsage& usage : getMemoryUsage()){
+        switch(usage.sizedBy){
+            case ClayManCapacity::ELEMENTS: elementPeak = std::max(elementPeak, usage.peak); break;
+            case ClayManCapacity::MEASURE_TEXT_CACHE_WORDS: wordPeak = std::max(wordPeak, usage.peak); break;
+            case ClayManCapacity::SCROLL_CONTAINERS: scrollPeak = std::max(scrollPeak, usage.peak); break;
+            case ClayManCapacity::FIXED: break;
+        }
+    }
+    capacities.maxElementCount = (int32_t)std::ceil(elementPeak * headroom);
+    capacities.maxMeasureTextCacheWordCount = (int32_t)std::ceil(wordPeak * headroom);
+    capacities.maxScrollContainerCount = (int32_t)std::ceil(scrollPeak * headroom);
+
+    //Same sizing pass as Clay_MinMemorySize(), run on a context with the recommended settings
+    Clay_Context fakeContext = {
+        .maxElementCount = capacities.maxElementCount,
+        .maxMeasureTextCacheWordCount = capacities.maxMeasureTextCacheWordCount,
+        .maxScrollContainerCount = capacities.maxScrollContainerCount,
+        .internalArena = {
+            .capacity = SIZE_MAX,
+            .memory = NULL,
+        }
+    };
+    Clay__Context_Allocate_Arena(&fakeContext.internalArena);
+    Clay__InitializePersistentMemory(&fakeContext);
+    Clay__InitializeEphemeralMemory(&fakeContext);
+    capacities.arenaBytes = fakeContext.internalArena.nextAllocation + 128;
+    return capacities;
+}
+
+void ClayMan::printMemoryUsage(float headroom){
+    static const char* capacityNames[] = {"elements", "words", "scroll", "fixed"};
+    size_t totalBytes = 0;
+    printf("%-36s %-9s %10s %10s %10s %12s\n", "array", "sizedBy", "length", "peak", "capacity", "bytes");
+    for(const ClayManArrayUsage& usage : getMemoryUsage()){
+        printf("%-36s %-9s %10d %10d %10d %12zu\n", usage.name, capacityNames[(int)usage.sizedBy],
+            usage.length, usage.peak, usage.capacity, usage.bytesReserved);
+        totalBytes += usage.bytesReserved;
+    }
+    Clay_Context* context = Clay_GetCurrentContext();
+    ClayManCapacities capacities = getRecommendedCapacities(headroom);
+    printf("arrays reserve %zu bytes, arena capacity %zu bytes\n", totalBytes, context ? context->internalArena.capacity : (size_t)0);
+    printf("recommended with %.0f%% headroom: maxElementCount %d, maxMeasureTextCacheWordCount %d, maxScrollContainerCount %d, arena %zu bytes\n",
+        (headroom - 1.0f) * 100.0f, capacities.maxElementCount, capacities.maxMeasureTextCacheWordCount,
+        capacities.maxScrollContainerCount, capacities.arenaBytes);
+}
+
+void ClayMan::resetMemoryPeaks(){
+    for(ClayManArrayUsage& usage : memoryUsage){
+        usage.peak = usage.length;
+    }
+}
+
+bool ClayMan::writeTrace(const std::string& path){
+#ifdef CLAY_TRACE
+    FILE* file = fopen(path.c_str(), "w");
+    if(!file){
+        printf("WARN: Could not open %s for the trace.", path.c_str());
+        return false;
+    }
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+    uint64_t end = traceWriteIndex.load(std::memory_order_acquire);
+    uint64_t begin = std::max(traceReadIndex.load(std::memory_order_relaxed), end > traceCapacity ? end - traceCapacity : 0);
+    bool first = true;
+    for(uint64_t index = begin; index < end; index++){
+        ClayManTraceEvent& event = traceEvents[index & (traceCapacity - 1)];
+        if(event.sequence.load(std::memory_order_acquire) != index + 1){
+            continue;
+        }
+        const char* name = event.name.load(std::memory_order_relaxed);
+        int64_t nanoseconds = event.nanoseconds.load(std::memory_order_relaxed);
+        uint32_t threadId = event.threadId.load(std::memory_order_relaxed);
+        char phase = event.phase.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        //Overwritten by a writer while it was being read
+        if(event.sequence.load(std::memory_order_relaxed) != index + 1){
+            continue;
+        }
+        fprintf(file, "%s\n{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, \"tid\": %u}",
+            first ? "" : ",", name, phase, nanoseconds / 1000.0, threadId);
+        first = false;
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return true;
+#else
+    (void)path;
+    printf("WARN: Tracing is compiled out, define CLAY_TRACE to record a trace.");
+    return false;
+#endif
+}
+
+void ClayMan::clearTrace(){
+#ifdef CLAY_TRACE
+    traceReadIndex.store(traceWriteIndex.load(std::memory_order_relaxed), std::memory_order_relaxed);
+#endif
+}
+
+void ClayMan::sizingAnalysisHook(Clay_SizingAnalysis analysis, void* userData){
+    ClayMan& clayMan = *(ClayMan*)userData;
+    if(!analysis.finished){
+        clayMan.sizingStart = std::chrono::steady_clock::now();
+        return;
+    }
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - clayMan.sizingStart).count();
+    clayMan.analyzedSizingMilliseconds += milliseconds;
+    SizingAccumulator& accumulator = clayMan.sizingAccumulators[analysis.elementId];
+    ClayManSizingHotspot& hotspot = accumulator.hotspot;
+    if(hotspot.frames == 0 && accumulator.lastFrame == UINT32_MAX){
+        hotspot.elementId = analysis.elementId;
+        hotspot.name = elementName(analysis.elementId);
+    }
+    if(accumulator.lastFrame != clayMan.analyzedFrames){
+        accumulator.lastFrame = clayMan.analyzedFrames;
+        accumulator.frameIterations = 0;
+        hotspot.frames++;
+    }
+    hotspot.childCount = (uint32_t)analysis.childCount;
+    if(analysis.alongLayoutAxis){
+        hotspot.growChildCount = (uint32_t)analysis.growChildCount;
+    }
+    accumulator.frameIterations += (uint32_t)analysis.iterations;
+    hotspot.maxIterations = std::max(hotspot.maxIterations, accumulator.frameIterations);
+    hotspot.totalIterations += (uint64_t)analysis.iterations;
+    //Compressing is only possible along the layout axis, so this counts each frame once
+    if(analysis.compressedOverflow){
+        hotspot.compressedFrames++;
+    }
+    hotspot.milliseconds += milliseconds;
+}
+
+void ClayMan::finishLayoutAnalysisFrame(){
+    if(frameMaxDepth > layoutAnalysis.maxDepth){
+        layoutAnalysis.maxDepth = frameMaxDepth;
+        layoutAnalysis.deepestElementId = frameDeepestElementId;
+        layoutAnalysis.deepestElementName = elementName(frameDeepestElementId);
+    }
+    frameMaxDepth = 0;
+    analyzedFrames++;
+}
+
+void ClayMan::setLayoutAnalysisEnabled(bool enabled){
+    if(!Clay_GetCurrentContext()){
+        return;
+    }
+    layoutAnalysisEnabled = enabled;
+    measureTextTimed = measureTextTimingEnabled || layoutAnalysisEnabled;
+    Clay_SetSizingAnalysisFunction(enabled ? sizingAnalysisHook : nullptr, this);
+}
+
+const ClayManLayoutAnalysis& ClayMan::getLayoutAnalysis(){
+    layoutAnalysis.frames = analyzedFrames;
+    layoutAnalysis.sizingMilliseconds = analyzedSizingMilliseconds;
+    layoutAnalysis.sizing.clear();
+    for(const auto& [id, accumulator] : sizingAccumulators){
+        layoutAnalysis.sizing.push_back(accumulator.hotspot);
+    }
+    std::sort(layoutAnalysis.sizing.begin(), layoutAnalysis.sizing.end(), [](const ClayManSizingHotspot& a, const ClayManSizingHotspot& b){
+        return a.milliseconds > b.milliseconds;
+    });
+    layoutAnalysis.textMisses.clear();
+    for(const auto& [id, accumulator] : textMissAccumulators){
+        layoutAnalysis.textMisses.push_back(accumulator.hotspot);
+    }
+    std::sort(layoutAnalysis.textMisses.begin(), layoutAnalysis.textMisses.end(), [](const ClayManTextMissHotspot& a, const ClayManTextMissHotspot& b){
+        return a.frames != b.frames ? a.frames > b.frames : a.misses > b.misses;
+    });
+    return layoutAnalysis;
+}
+
+void ClayMan::printLayoutAnalysis(size_t count){
+    const ClayManLayoutAnalysis& analysis = getLayoutAnalysis();
+    if(analysis.frames == 0){
+        printf("No frames analyzed, call setLayoutAnalysisEnabled(true) before beginLayout().\n");
+        return;
+    }
+    auto label = [](const std::string& name, uint32_t id){
+        static char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*s#%u", name.empty() ? 0 : 40, name.c_str(), id);
+        return (const char*)buffer;
+    };
+    printf("%u frames analyzed, %.3f ms/frame sizing children\n", analysis.frames, analysis.sizingMilliseconds / analysis.frames);
+    printf("%-48s %10s %8s %6s %9s %10s  %s\n", "parent", "ms/frame", "children", "grow", "maxPasses", "compressed", "hint");
+    for(size_t i = 0; i < analysis.sizing.size() && i < count; i++){
+        const ClayManSizingHotspot& hotspot = analysis.sizing[i];
+        const char* hint = "";
+        if(hotspot.compressedFrames > 0){
+            hint = "children overflow a container that cannot scroll, give it scrolling or fixed children";
+        }else if(hotspot.maxIterations > 8){
+            hint = "many GROW passes, give GROW siblings equal base sizes or fewer distinct sizes";
+        }else if(hotspot.childCount > 256){
+            hint = "very wide parent, split it or virtualize the children";
+        }
+        printf("%-48s %10.4f %8u %6u %9u %10u  %s\n", label(hotspot.name, hotspot.elementId), hotspot.milliseconds / analysis.frames,
+            hotspot.childCount, hotspot.growChildCount, hotspot.maxIterations, hotspot.compressedFrames, hint);
+    }
+    printf("deepest nesting %u at %s%s\n", analysis.maxDepth, label(analysis.deepestElementName, analysis.deepestElementId),
+        analysis.maxDepth > 32 ? ", deep trees cost a BFS and DFS pass per level, flatten wrappers without their own sizing or background" : "");
+    size_t printed = 0;
+    for(const ClayManTextMissHotspot& hotspot : analysis.textMisses){
+        if(printed == count || hotspot.longestStreak < 2){
+            continue;
+        }
+        if(printed++ == 0){
+            printf("%-48s %8s %8s %8s\n", "text parent missing the measure cache", "frames", "misses", "streak");
+        }
+        printf("%-48s %8u %8llu %8u\n", label(hotspot.parentName, hotspot.parentId), hotspot.frames, (unsigned long long)hotspot.misses, hotspot.longestStreak);
+    }
+    if(printed > 0){
+        printf("text measured again on consecutive frames changed content or address, keep strings stable or set hashStringContents for text rebuilt at new addresses\n");
+    }
+}
+
+void ClayMan::resetLayoutAnalysis(){
+    analyzedFrames = 0;
+    analyzedSizingMilliseconds = 0;
+    sizingAccumulators.clear();
+    textMissAccumulators.clear();
+    frameMaxDepth = 0;
+    layoutAnalysis = ClayManLayoutAnalysis();
+}
+
+//First bytes of a capture file. Declarations and text configs are stored as raw structs, so a capture only replays against the same clay.h layout
+struct ClayManCaptureHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t declarationSize;
+    uint32_t textConfigSize;
+    uint32_t scrollContainerSize;
+    int32_t maxElementCount;
+    int32_t maxMeasureTextCacheWordCount;
+    int32_t maxScrollContainerCount;
+    uint32_t width;
+    uint32_t height;
+    uint32_t flags;
+    uint32_t frameCount;
+};
+
+static const char captureMagic[8] = {'C', 'L', 'A', 'Y', 'C', 'A', 'P', 0};
+static constexpr uint32_t captureVersion = 3;
+static constexpr uint32_t captureFlagRenderCommands = 1;
+
+static bool validCaptureHeader(const ClayManCaptureHeader& header){
+    return memcmp(header.magic, captureMagic, sizeof(captureMagic)) == 0 && header.version == captureVersion
+        && header.declarationSize == sizeof(Clay_ElementDeclaration) && header.textConfigSize == sizeof(Clay_TextElementConfig)
+        && header.scrollContainerSize == sizeof(Clay__ScrollContainerDataInternal);
+}
+
+//Measurements are looked up by the text and the config fields measure functions use
+static void makeMeasurementKey(std::string& key, const char* chars, int32_t length, const Clay_TextElementConfig* config){
+    const uint16_t metrics[4] = {config->fontId, config->fontSize, config->letterSpacing, config->lineHeight};
+    key.assign((const char*)metrics, sizeof(metrics));
+    key.append(chars, (size_t)length);
+}
+
+template<typename T>
+static void appendValue(std::vector<uint8_t>& out, const T& value){
+    const uint8_t* bytes = (const uint8_t*)&value;
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+//Writes the fields of a render command without padding, with text by content instead of address, so equal commands give equal bytes in any process
+static void serializeRenderCommand(std::vector<uint8_t>& out, const Clay_RenderCommand& command){
+    const Clay_RenderData& data = command.renderData;
+    appendValue(out, command.boundingBox.x);
+    appendValue(out, command.boundingBox.y);
+    appendValue(out, command.boundingBox.width);
+    appendValue(out, command.boundingBox.height);
+    appendValue(out, command.id);
+    appendValue(out, command.zIndex);
+    appendValue(out, (uint8_t)command.commandType);
+    appendValue(out, (uint64_t)(uintptr_t)command.userData);
+    auto appendColor = [&](const Clay_Color& color){
+        appendValue(out, color.r);
+        appendValue(out, color.g);
+        appendValue(out, color.b);
+        appendValue(out, color.a);
+    };
+    auto appendCornerRadius = [&](const Clay_CornerRadius& radius){
+        appendValue(out, radius.topLeft);
+        appendValue(out, radius.topRight);
+        appendValue(out, radius.bottomLeft);
+        appendValue(out, radius.bottomRight);
+    };
+    switch(command.commandType){
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+            appendColor(data.rectangle.backgroundColor);
+            appendCornerRadius(data.rectangle.cornerRadius);
+            break;
+        case CLAY_RENDER_COMMAND_TYPE_BORDER:
+            appendColor(data.border.color);
+            appendCornerRadius(data.border.cornerRadius);
+            appendValue(out, data.border.width.left);
+            appendValue(out, data.border.width.right);
+            appendValue(out, data.border.width.top);
+            appendValue(out, data.border.width.bottom);
+            appendValue(out, data.border.width.betweenChildren);
+            break;
+        case CLAY_RENDER_COMMAND_TYPE_TEXT:
+            appendValue(out, data.text.stringContents.length);
+            out.insert(out.end(), data.text.stringContents.chars, data.text.stringContents.chars + data.text.stringContents.length);
+            appendColor(data.text.textColor);
+            appendValue(out, data.text.fontId);
+            appendValue(out, data.text.fontSize);
+            appendValue(out, data.text.letterSpacing);
+            appendValue(out, data.text.lineHeight);
+            break;
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+            appendColor(data.image.backgroundColor);
+            appendCornerRadius(data.image.cornerRadius);
+            appendValue(out, data.image.sourceDimensions.width);
+            appendValue(out, data.image.sourceDimensions.height);
+            appendValue(out, (uint64_t)(uintptr_t)data.image.imageData);
+            break;
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+            appendColor(data.custom.backgroundColor);
+            appendCornerRadius(data.custom.cornerRadius);
+            appendValue(out, (uint64_t)(uintptr_t)data.custom.customData);
+            break;
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
+            appendValue(out, (uint8_t)data.scroll.horizontal);
+            appendValue(out, (uint8_t)data.scroll.vertical);
+            break;
+        default:
+            break;
+    }
+}
+
+//Hashes the same fields serializeRenderCommand() writes, text by content since ClayMan's strings move every frame
+void ClayMan::fingerprintRenderCommands(const Clay_RenderCommandArray& renderCommands){
+    uint64_t hash = hashValue(14695981039346656037ull, renderCommands.length);
+    for(int32_t i = 0; i < renderCommands.length; i++){
+        const Clay_RenderCommand& command = renderCommands.internalArray[i];
+        const Clay_RenderData& data = command.renderData;
+        hash = hashValue(hash, command.boundingBox);
+        const uint64_t header[2] = {
+            (uint64_t)command.id | (uint64_t)(uint16_t)command.zIndex << 32 | (uint64_t)command.commandType << 48,
+            (uint64_t)(uintptr_t)command.userData
+        };
+        hash = hashValue(hash, header);
+        switch(command.commandType){
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+                hash = hashValue(hash, data.rectangle.backgroundColor);
+                hash = hashValue(hash, data.rectangle.cornerRadius);
+                break;
+            case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+                const Clay_BorderWidth& width = data.border.width;
+                const uint16_t widths[5] = {width.left, width.right, width.top, width.bottom, width.betweenChildren};
+                hash = hashValue(hash, data.border.color);
+                hash = hashValue(hash, data.border.cornerRadius);
+                hash = hashValue(hash, widths);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                const Clay_TextRenderData& text = data.text;
+                const uint16_t metrics[4] = {text.fontId, text.fontSize, text.letterSpacing, text.lineHeight};
+                hash = hashValue(hash, text.stringContents.length);
+                hash = hashWords(hash, text.stringContents.chars, (size_t)text.stringContents.length);
+                hash = hashValue(hash, text.textColor);
+                hash = hashValue(hash, metrics);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+                hash = hashValue(hash, data.image.backgroundColor);
+                hash = hashValue(hash, data.image.cornerRadius);
+                hash = hashValue(hash, data.image.sourceDimensions);
+                hash = hashValue(hash, (uint64_t)(uintptr_t)data.image.imageData);
+                break;
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+                hash = hashValue(hash, data.custom.backgroundColor);
+                hash = hashValue(hash, data.custom.cornerRadius);
+                hash = hashValue(hash, (uint64_t)(uintptr_t)data.custom.customData);
+                break;
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+                const uint8_t scroll[2] = {data.scroll.horizontal, data.scroll.vertical};
+                hash = hashValue(hash, scroll);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    frameChanges.visualChanged = hash != frameChanges.renderFingerprint;
+    frameChanges.renderFingerprint = hash;
+}
+
+void ClayMan::startPipeline(){
+    std::lock_guard<std::mutex> lock(pipelineMutex);
+    pipelineRunning = true;
+}
+
+void ClayMan::startRenderThread(std::function<void(Clay_RenderCommandArray renderCommands)> render){
+    stopPipeline();
+    startPipeline();
+    renderThread = std::thread([this, render](){
+        while(ClayManFrameSnapshot* frame = acquireFrame()){
+            render(frame->renderCommands());
+        }
+    });
+}
+
+void ClayMan::submitFrame(const Clay_RenderCommandArray& renderCommands){
+    std::unique_lock<std::mutex> lock(pipelineMutex);
+    if(!pipelineRunning){
+        printf("WARN: submitFrame() needs startPipeline() or startRenderThread(), frame dropped\n");
+        return;
+    }
+    pipelineCondition.wait(lock, [&](){
+        return pipelineReady < 0 || !pipelineRunning;
+    });
+    if(!pipelineRunning){
+        return;
+    }
+    //The render side only touches the acquired buffer until this one is marked ready
+    const int slot = pipelineAcquired == 0 ? 1 : 0;
+    lock.unlock();
+
+    ClayManFrameSnapshot& frame = pipelineFrames[slot];
+    frame.commands.assign(renderCommands.internalArray, renderCommands.internalArray + renderCommands.length);
+    frame.text.clear();
+    for(const Clay_RenderCommand& command : frame.commands){
+        if(command.commandType == CLAY_RENDER_COMMAND_TYPE_TEXT){
+            const Clay_StringSlice& contents = command.renderData.text.stringContents;
+            frame.text.insert(frame.text.end(), contents.chars, contents.chars + contents.length);
+        }
+    }
+    //Point the slices at the copy only once it stopped growing
+    size_t offset = 0;
+    for(Clay_RenderCommand& command : frame.commands){
+        if(command.commandType == CLAY_RENDER_COMMAND_TYPE_TEXT){
+            Clay_StringSlice& contents = command.renderData.text.stringContents;
+            contents.chars = frame.text.data() + offset;
+            contents.baseChars = contents.chars;
+            offset += contents.length;
+        }
+    }
+    frame.frameNumber = ++submittedFrameCount;
+
+    lock.lock();
+    pipelineReady = slot;
+    lock.unlock();
+    pipelineCondition.notify_all();
+}
+
+ClayManFrameSnapshot* ClayMan::acquireFrame(){
+    std::unique_lock<std::mutex> lock(pipelineMutex);
+    pipelineAcquired = -1;
+    pipelineCondition.wait(lock, [&](){
+        return pipelineReady >= 0 || !pipelineRunning;
+    });
+    if(!pipelineRunning){
+        return nullptr;
+    }
+    const int slot = pipelineReady;
+    pipelineAcquired = slot;
+    pipelineReady = -1;
+    lock.unlock();
+    pipelineCondition.notify_all();
+    return &pipelineFrames[slot];
+}
+
+void ClayMan::releaseFrame(){
+    std::lock_guard<std::mutex> lock(pipelineMutex);
+    pipelineAcquired = -1;
+}
+
+void ClayMan::stopPipeline(){
+    {
+        std::lock_guard<std::mutex> lock(pipelineMutex);
+        pipelineRunning = false;
+    }
+    pipelineCondition.notify_all();
+    if(renderThread.joinable()){
+        renderThread.join();
+    }
+    std::lock_guard<std::mutex> lock(pipelineMutex);
+    pipelineReady = -1;
+    pipelineAcquired = -1;
+}
+
+bool ClayMan::startCapture(const std::string& path, bool storeRenderCommands){
+    stopCapture();
+    Clay_Context* context = Clay_GetCurrentContext();
+    if(!context){
+        printf("WARN: Clay is not initialized, nothing to capture.");
+        return false;
+    }
+    captureFile = fopen(path.c_str(), "wb");
+    if(!captureFile){
+        printf("WARN: Could not open %s for the capture.", path.c_str());
+        return false;
+    }
+    ClayManCaptureHeader header = {};
+    memcpy(header.magic, captureMagic, sizeof(captureMagic));
+    header.version = captureVersion;
+    header.declarationSize = sizeof(Clay_ElementDeclaration);
+    header.textConfigSize = sizeof(Clay_TextElementConfig);
+    header.scrollContainerSize = sizeof(Clay__ScrollContainerDataInternal);
+    header.maxElementCount = context->maxElementCount;
+    header.maxMeasureTextCacheWordCount = context->maxMeasureTextCacheWordCount;
+    header.maxScrollContainerCount = context->maxScrollContainerCount;
+    header.width = windowWidth;
+    header.height = windowHeight;
+    header.flags = storeRenderCommands ? captureFlagRenderCommands : 0;
+    fwrite(&header, sizeof(header), 1, captureFile);
+    captureBuffer.clear();
+    capturedMeasurements.clear();
+    captureRenderCommands = storeRenderCommands;
+    capturedFrames = 0;
+    captureScrollStatePending = true;
+    //Text measured before the capture would be missing from it, so everything is measured again
+    Clay_ResetMeasureTextCache();
+    return true;
+}
+
+void ClayMan::stopCapture(){
+    if(!captureFile){
+        return;
+    }
+    fwrite(captureBuffer.data(), 1, captureBuffer.size(), captureFile);
+    fseek(captureFile, offsetof(ClayManCaptureHeader, frameCount), SEEK_SET);
+    fwrite(&capturedFrames, sizeof(capturedFrames), 1, captureFile);
+    fclose(captureFile);
+    captureFile = nullptr;
+    captureBuffer.clear();
+    capturedMeasurements.clear();
+}
+
+void ClayMan::captureScrollState(){
+    //Taken after the first frame's updateClayState() applied scrolling and momentum, which a replay cannot redo without the previous frame's layout
+    captureScrollStatePending = false;
+    Clay__ScrollContainerDataInternalArray& scrollContainers = Clay_GetCurrentContext()->scrollContainerDatas;
+    captureBuffer.push_back('S');
+    captureBytes(&scrollContainers.length, sizeof(scrollContainers.length));
+    captureBytes(scrollContainers.internalArray, sizeof(Clay__ScrollContainerDataInternal) * (size_t)scrollContainers.length);
+}
+
+void ClayMan::captureMeasurement(Clay_StringSlice text, const Clay_TextElementConfig* config, Clay_Dimensions dimensions){
+    std::string key;
+    makeMeasurementKey(key, text.chars, text.length, config);
+    if(!capturedMeasurements.insert(key).second){
+        return;
+    }
+    uint32_t keyLength = (uint32_t)key.size();
+    captureBuffer.push_back('M');
+    captureBytes(&keyLength, sizeof(keyLength));
+    captureBytes(key.data(), key.size());
+    captureBytes(&dimensions, sizeof(dimensions));
+}
+
+void ClayMan::captureFrame(const Clay_RenderCommandArray& renderCommands){
+    captureBuffer.push_back('E');
+    captureBytes(&renderCommands.length, sizeof(renderCommands.length));
+    if(captureRenderCommands){
+        size_t sizeOffset = captureBuffer.size();
+        uint32_t byteCount = 0;
+        captureBytes(&byteCount, sizeof(byteCount));
+        for(int32_t i = 0; i < renderCommands.length; i++){
+            serializeRenderCommand(captureBuffer, renderCommands.internalArray[i]);
+        }
+        byteCount = (uint32_t)(captureBuffer.size() - sizeOffset - sizeof(byteCount));
+        memcpy(&captureBuffer[sizeOffset], &byteCount, sizeof(byteCount));
+    }
+    fwrite(captureBuffer.data(), 1, captureBuffer.size(), captureFile);
+    captureBuffer.clear();
+    capturedFrames++;
+}
+
+bool ClayMan::readCaptureInfo(const std::string& path, ClayManCaptureInfo& info){
+    FILE* file = fopen(path.c_str(), "rb");
+    if(!file){
+        return false;
+    }
+    ClayManCaptureHeader header = {};
+    bool read = fread(&header, sizeof(header), 1, file) == 1;
+    fclose(file);
+    if(!read || !validCaptureHeader(header)){
+        return false;
+    }
+    info.maxElementCount = header.maxElementCount;
+    info.maxMeasureTextCacheWordCount = header.maxMeasureTextCacheWordCount;
+    info.maxScrollContainerCount = header.maxScrollContainerCount;
+    info.width = header.width;
+    info.height = header.height;
+    info.frameCount = header.frameCount;
+    info.hasRenderCommands = (header.flags & captureFlagRenderCommands) != 0;
+    return true;
+}
+
+//Bounds-checked cursor over a capture file in memory
+struct ClayManCaptureReader {
+    const uint8_t* data;
+    size_t size;
+    size_t position = 0;
+    bool failed = false;
+
+    const uint8_t* bytes(size_t count){
+        if(failed || size - position < count){
+            failed = true;
+            return nullptr;
+        }
+        const uint8_t* start = data + position;
+        position += count;
+        return start;
+    }
+
+    template<typename T>
+    T value(){
+        T result = {};
+        if(const uint8_t* source = bytes(sizeof(T))){
+            memcpy(&result, source, sizeof(T));
+        }
+        return result;
+    }
+};
+
+//State the replay measure function and string storage share
+struct ClayManReplayState {
+    std::unordered_map<std::string, Clay_Dimensions> measurements;
+    std::string key;
+    uint32_t missingMeasurements = 0;
+    //One buffer per captured string address, so text hashed by address keeps hitting the same cache entries
+    std::unordered_map<uint64_t, std::vector<char>> strings;
+    //Buffers that had to grow, kept until the frame is done since Clay still points into them
+    std::vector<std::vector<char>> retiredStrings;
+    std::vector<uint8_t> commandBytes;
+};
+
+static Clay_Dimensions replayMeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void* userData){
+    ClayManReplayState& state = *(ClayManReplayState*)userData;
+    makeMeasurementKey(state.key, text.chars, text.length, config);
+    auto found = state.measurements.find(state.key);
+    if(found == state.measurements.end()){
+        state.missingMeasurements++;
+        return {0, 0};
+    }
+    return found->second;
+}
+
+static const char* replayString(ClayManReplayState& state, ClayManCaptureReader& reader, int32_t& length){
+    uint64_t address = reader.value<uint64_t>();
+    length = reader.value<int32_t>();
+    const uint8_t* chars = reader.bytes(length > 0 ? (size_t)length : 0);
+    if(reader.failed || address == 0){
+        return nullptr;
+    }
+    std::vector<char>& slot = state.strings[address];
+    if(slot.size() < (size_t)length || slot.empty()){
+        if(!slot.empty()){
+            state.retiredStrings.push_back(std::move(slot));
+        }
+        slot.assign(length > 0 ? (size_t)length : 1, 0);
+    }
+    if(length > 0){
+        memcpy(slot.data(), chars, (size_t)length);
+    }
+    return slot.data();
+}
+
+bool ClayMan::replayCapture(const std::string& path, ClayManReplayResult& result, bool compare){
+    result = {};
+    FILE* file = fopen(path.c_str(), "rb");
+    if(!file){
+        printf("WARN: Could not open capture %s.", path.c_str());
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t chunk[65536];
+    size_t chunkSize;
+    while((chunkSize = fread(chunk, 1, sizeof(chunk), file)) > 0){
+        data.insert(data.end(), chunk, chunk + chunkSize);
+    }
+    fclose(file);
+    ClayManCaptureHeader header = {};
+    if(data.size() < sizeof(header)){
+        printf("WARN: %s is not a ClayMan capture.", path.c_str());
+        return false;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if(!validCaptureHeader(header)){
+        printf("WARN: %s was captured with a different clay.h or ClayMan version.", path.c_str());
+        return false;
+    }
+    compare = compare && (header.flags & captureFlagRenderCommands);
+
+    ClayManReplayState state;
+    //Measurements are written after the op that needed them, so they are all loaded up front
+    ClayManCaptureReader scan = {data.data(), data.size(), sizeof(header)};
+    while(!scan.failed && scan.position < scan.size){
+        int32_t length = 0;
+        switch(scan.value<uint8_t>()){
+            case 'U': scan.bytes(sizeof(uint32_t) * 2 + sizeof(float) * 6); break;
+            case 'B': case 'O': case 'X': break;
+            case 'S': length = scan.value<int32_t>(); scan.bytes(length > 0 ? sizeof(Clay__ScrollContainerDataInternal) * (size_t)length : 0); break;
+            case 'C': scan.bytes(sizeof(Clay_ElementDeclaration)); scan.bytes(sizeof(uint64_t)); length = scan.value<int32_t>(); scan.bytes(length > 0 ? length : 0); break;
+            case 'T': scan.bytes(sizeof(uint64_t)); length = scan.value<int32_t>(); scan.bytes(length > 0 ? length : 0); scan.bytes(sizeof(Clay_TextElementConfig)); break;
+            case 'E': scan.bytes(sizeof(int32_t)); if(header.flags & captureFlagRenderCommands){ scan.bytes(scan.value<uint32_t>()); } break;
+            case 'M': {
+                uint32_t keyLength = scan.value<uint32_t>();
+                const uint8_t* key = scan.bytes(keyLength);
+                Clay_Dimensions dimensions = scan.value<Clay_Dimensions>();
+                if(!scan.failed){
+                    state.measurements[std::string((const char*)key, keyLength)] = dimensions;
+                }
+                break;
+            }
+            default: scan.failed = true; break;
+        }
+    }
+    if(scan.failed){
+        printf("WARN: %s is truncated or corrupt.", path.c_str());
+        return false;
+    }
+
+    Clay_Context* context = Clay_GetCurrentContext();
+    auto previousMeasureText = Clay__MeasureText == measureTextHook ? userMeasureText : Clay__MeasureText;
+    void* previousMeasureTextUserData = context->measureTextUserData;
+    Clay_SetMeasureTextFunction(replayMeasureText, &state);
+
+    ClayManCaptureReader reader = {data.data(), data.size(), sizeof(header)};
+    auto frameStart = std::chrono::steady_clock::now();
+    bool frameTimed = false;
+    while(!reader.failed && reader.position < reader.size){
+        uint8_t op = reader.value<uint8_t>();
+        switch(op){
+            case 'U': {
+                uint32_t width = reader.value<uint32_t>();
+                uint32_t height = reader.value<uint32_t>();
+                float floats[6];
+                for(float& value : floats){
+                    value = reader.value<float>();
+                }
+                frameStart = std::chrono::steady_clock::now();
+                frameTimed = true;
+                updateClayState(width, height, floats[0], floats[1], floats[2], floats[3], floats[4], floats[5] != 0.0f);
+                break;
+            }
+            case 'B':
+                if(!frameTimed){
+                    frameStart = std::chrono::steady_clock::now();
+                }
+                state.retiredStrings.clear();
+                beginLayout();
+                break;
+            case 'O':
+                //An open followed by its configure replays as one openElement(configs) call
+                if(reader.position < reader.size && data[reader.position] == 'C'){
+                    reader.position++;
+                    Clay_ElementDeclaration configs = reader.value<Clay_ElementDeclaration>();
+                    configs.id.stringId.chars = replayString(state, reader, configs.id.stringId.length);
+                    openElement(configs);
+                }else{
+                    openElement();
+                }
+                break;
+            case 'C': {
+                Clay_ElementDeclaration configs = reader.value<Clay_ElementDeclaration>();
+                configs.id.stringId.chars = replayString(state, reader, configs.id.stringId.length);
+                applyElementConfigs(configs);
+                break;
+            }
+            case 'X':
+                closeElement();
+                break;
+            case 'S': {
+                //Replaces every scroll container, also ones left over from an earlier replay, with the captured ones
+                Clay__ScrollContainerDataInternalArray& scrollContainers = context->scrollContainerDatas;
+                scrollContainers.length = 0;
+                Clay__RebuildScrollContainerHashMap();
+                int32_t count = reader.value<int32_t>();
+                for(int32_t i = 0; i < count && !reader.failed; i++){
+                    Clay__ScrollContainerDataInternal scrollContainer = reader.value<Clay__ScrollContainerDataInternal>();
+                    //Set again when the layout opens the container
+                    scrollContainer.layoutElement = nullptr;
+                    scrollContainer.openThisFrame = false;
+                    Clay__AddScrollContainerData(scrollContainer);
+                }
+                break;
+            }
+            case 'T': {
+                Clay_String text = {};
+                text.chars = replayString(state, reader, text.length);
+                Clay_TextElementConfig config = reader.value<Clay_TextElementConfig>();
+                textElement(text, config);
+                break;
+            }
+            case 'M':
+                reader.bytes(reader.value<uint32_t>() + sizeof(Clay_Dimensions));
+                break;
+            case 'E': {
+                int32_t commandCount = reader.value<int32_t>();
+                const uint8_t* expected = nullptr;
+                uint32_t expectedSize = 0;
+                if(header.flags & captureFlagRenderCommands){
+                    expectedSize = reader.value<uint32_t>();
+                    expected = reader.bytes(expectedSize);
+                }
+                Clay_RenderCommandArray renderCommands = endLayout();
+                double frameMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+                result.layoutMilliseconds += frameMilliseconds;
+                result.maxFrameMilliseconds = std::max(result.maxFrameMilliseconds, frameMilliseconds);
+                frameTimed = false;
+                if(compare && expected){
+                    //Walks both streams command by command so the first differing command can be reported
+                    int32_t mismatch = -1;
+                    size_t offset = 0;
+                    for(int32_t i = 0; i < renderCommands.length && mismatch < 0; i++){
+                        state.commandBytes.clear();
+                        serializeRenderCommand(state.commandBytes, renderCommands.internalArray[i]);
+                        if(offset + state.commandBytes.size() > expectedSize || memcmp(expected + offset, state.commandBytes.data(), state.commandBytes.size()) != 0){
+                            mismatch = i;
+                        }
+                        offset += state.commandBytes.size();
+                    }
+                    if(mismatch < 0 && (renderCommands.length != commandCount || offset != expectedSize)){
+                        mismatch = std::min(renderCommands.length, commandCount);
+                    }
+                    if(mismatch >= 0){
+                        if(result.firstMismatchFrame < 0){
+                            result.firstMismatchFrame = result.frames;
+                            result.firstMismatchCommand = mismatch;
+                        }
+                        result.mismatchedFrames++;
+                    }
+                }
+                result.frames++;
+                break;
+            }
+            default:
+                reader.failed = true;
+                break;
+        }
+    }
+    result.missingMeasurements = state.missingMeasurements;
+    Clay_SetMeasureTextFunction(previousMeasureText, previousMeasureTextUserData);
+    return !reader.failed;
+}
+
+uint32_t ClayMan::getElementCount(){
+    return (uint32_t)Clay_GetCurrentContext()->layoutElements.length;
+}
+//Commands that can be reordered, scissors and custom commands are barriers since they change state a backend cannot see
+static bool isReorderableCommand(const Clay_RenderCommand& command){
+    switch(command.commandType){
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+        case CLAY_RENDER_COMMAND_TYPE_BORDER:
+        case CLAY_RENDER_COMMAND_TYPE_TEXT:
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//Touching edges do not count as overlap
+static bool boundsOverlap(const Clay_BoundingBox& a, const Clay_BoundingBox& b){
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+static uint16_t commandFontId(const Clay_RenderCommand& command){
+    return command.commandType == CLAY_RENDER_COMMAND_TYPE_TEXT ? command.renderData.text.fontId : 0;
+}
+
+static void* commandImageData(const Clay_RenderCommand& command){
+    return command.commandType == CLAY_RENDER_COMMAND_TYPE_IMAGE ? command.renderData.image.imageData : nullptr;
+}
+
+void ClayMan::flushReorderBatches(){
+    for(const ReorderBatch& batch : reorderBatches){
+        for(uint32_t i = batch.first; ; i = reorderNext[i]){
+            reorderIndices.push_back(i);
+            if(i == batch.last){
+                break;
+            }
+        }
+    }
+    reorderBatches.clear();
+}
+
+void ClayMan::countDrawStates(const Clay_RenderCommandArray& renderCommands, const std::vector<uint32_t>& indices, uint32_t& stateChanges, uint32_t& drawCalls){
+    stateChanges = 0;
+    drawCalls = 0;
+    const Clay_RenderCommand* previous = nullptr;
+    for(uint32_t index : indices){
+        const Clay_RenderCommand& command = renderCommands.internalArray[index];
+        if(!isReorderableCommand(command)){
+            //Backends flush their batch on a barrier, so the next draw always starts a new call
+            previous = nullptr;
+            continue;
+        }
+        bool sameState = previous
+            && previous->commandType == command.commandType
+            && commandFontId(*previous) == commandFontId(command)
+            && commandImageData(*previous) == commandImageData(command);
+        if(!sameState){
+            drawCalls++;
+            if(previous){
+                stateChanges++;
+            }
+        }
+        previous = &command;
+    }
+}
+
+const std::vector<uint32_t>& ClayMan::reorderRenderCommands(const Clay_RenderCommandArray& renderCommands){
+    const uint32_t length = renderCommands.length > 0 ? (uint32_t)renderCommands.length : 0;
+    reorderIndices.clear();
+    reorderIndices.reserve(length);
+    reorderNext.resize(length);
+    reorderBatches.clear();
+
+    int16_t segmentZIndex = 0;
+    void* segmentUserData = nullptr;
+    for(uint32_t i = 0; i < length; i++){
+        const Clay_RenderCommand& command = renderCommands.internalArray[i];
+        if(!isReorderableCommand(command)){
+            flushReorderBatches();
+            reorderIndices.push_back(i);
+            continue;
+        }
+        //A userData change ends the segment too, layers are measured as one contiguous run of their tag and nothing may be moved into or out of it
+        if(!reorderBatches.empty() && (command.zIndex != segmentZIndex || command.userData != segmentUserData)){
+            flushReorderBatches();
+        }
+        segmentZIndex = command.zIndex;
+        segmentUserData = command.userData;
+
+        const uint16_t fontId = commandFontId(command);
+        void* imageData = commandImageData(command);
+        const Clay_BoundingBox& bounds = command.boundingBox;
+
+        //Walk back over the segment's batches. The command may join a batch with the same state only if it overlaps nothing drawn in the batches it moves in front of
+        ReorderBatch* target = nullptr;
+        size_t scanned = 0;
+        for(size_t b = reorderBatches.size(); b-- > 0 && scanned < reorderWindow; scanned++){
+            ReorderBatch& batch = reorderBatches[b];
+            if(batch.commandType == command.commandType && batch.fontId == fontId && batch.imageData == imageData){
+                target = &batch;
+                break;
+            }
+            bool blocked = false;
+            if(boundsOverlap(batch.bounds, bounds)){
+                for(uint32_t j = batch.first; ; j = reorderNext[j]){
+                    if(boundsOverlap(renderCommands.internalArray[j].boundingBox, bounds)){
+                        blocked = true;
+                        break;
+                    }
+                    if(j == batch.last){
+                        break;
+                    }
+                }
+            }
+            if(blocked){
+                break;
+            }
+        }
+
+        if(target){
+            reorderNext[target->last] = i;
+            target->last = i;
+            Clay_BoundingBox& united = target->bounds;
+            float right = std::max(united.x + united.width, bounds.x + bounds.width);
+            float bottom = std::max(united.y + united.height, bounds.y + bounds.height);
+            united.x = std::min(united.x, bounds.x);
+            united.y = std::min(united.y, bounds.y);
+            united.width = right - united.x;
+            united.height = bottom - united.y;
+        }else{
+            reorderBatches.push_back({command.commandType, fontId, imageData, bounds, i, i});
+        }
+    }
+    flushReorderBatches();
+
+    //reorderNext is no longer needed, reuse it as the original identity order for the before counts
+    reorderStats.commandCount = length;
+    countDrawStates(renderCommands, reorderIndices, reorderStats.stateChangesAfter, reorderStats.drawCallsAfter);
+    for(uint32_t i = 0; i < length; i++){
+        reorderNext[i] = i;
+    }
+    countDrawStates(renderCommands, reorderNext, reorderStats.stateChangesBefore, reorderStats.drawCallsBefore);
+    return reorderIndices;
+}
+
+Clay_RenderCommandArray ClayMan::reorderedRenderCommands(const Clay_RenderCommandArray& renderCommands){
+    const std::vector<uint32_t>& indices = reorderRenderCommands(renderCommands);
+    reorderedCommands.resize(indices.size());
+    for(size_t i = 0; i < indices.size(); i++){
+        reorderedCommands[i] = renderCommands.internalArray[indices[i]];
+    }
+    return Clay_RenderCommandArray{
+        .capacity = (int32_t)reorderedCommands.size(),
+        .length = (int32_t)reorderedCommands.size(),
+        .internalArray = reorderedCommands.data()
+    };
+}
+
+const ClayManReorderStats& ClayMan::getReorderStats() const {
+    return reorderStats;
+}
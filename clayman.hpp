@@ -2,6 +2,7 @@
 #define CLAY_MAN
 
 #include "include/clay.h"
+#include "include/clay_layer.h"
 
 #include <cstddef>
 // #include <iostream>
@@ -9,6 +10,15 @@
 #include <chrono>
 #include <functional>
 #include <cassert>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 /*
 
 ClayMan Repo: https://github.com/TimothyHoytBSME/ClayMan
@@ -44,6 +54,184 @@ freely, subject to the following restrictions:
 
 
 
+//Callbacks for the ClayMan event router, any of them may be left empty. Drag receives the pointer movement since last frame.
+struct ClayManEventHandlers {
+    std::function<void(Clay_ElementId)> onEnter;
+    std::function<void(Clay_ElementId)> onLeave;
+    std::function<void(Clay_ElementId)> onPress;
+    std::function<void(Clay_ElementId)> onRelease;
+    std::function<void(Clay_ElementId)> onClick;
+    std::function<void(Clay_ElementId, Clay_Vector2)> onDrag;
+};
+
+//Result of the last reorderRenderCommands() pass. State changes count switches of command type, font or image between consecutive draws, draw calls count runs of the same state
+struct ClayManReorderStats {
+    uint32_t commandCount = 0;
+    uint32_t stateChangesBefore = 0;
+    uint32_t stateChangesAfter = 0;
+    uint32_t drawCallsBefore = 0;
+    uint32_t drawCallsAfter = 0;
+};
+
+//Text measurement cache counters from Clay, plus the time spent inside the measure text function
+struct ClayManMeasureTextStats {
+    Clay_MeasureTextCacheStats cache = {};
+    double measureMilliseconds = 0;
+};
+
+//Header of a capture file. Set the Clay capacities from it before constructing the ClayMan that replays the capture
+struct ClayManCaptureInfo {
+    int32_t maxElementCount = 0;
+    int32_t maxMeasureTextCacheWordCount = 0;
+    int32_t maxScrollContainerCount = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t frameCount = 0;
+    bool hasRenderCommands = false;
+};
+
+//Outcome of replayCapture(). A frame mismatches when its render commands differ from the captured ones, the first difference is kept
+struct ClayManReplayResult {
+    uint32_t frames = 0;
+    uint32_t mismatchedFrames = 0;
+    int64_t firstMismatchFrame = -1;
+    int32_t firstMismatchCommand = -1;
+    //Text the capture has no measurement for, measured as 0x0
+    uint32_t missingMeasurements = 0;
+    double layoutMilliseconds = 0;
+    double maxFrameMilliseconds = 0;
+};
+
+enum class ClayManInputType : uint8_t {
+    POINTER_MOVE,
+    POINTER_DOWN,
+    POINTER_UP,
+    SCROLL,
+    RESIZE
+};
+
+//One input event for pushInput()
+struct ClayManInputEvent {
+    ClayManInputType type = ClayManInputType::POINTER_MOVE;
+    //Pointer position for POINTER_*, wheel delta for SCROLL, window size for RESIZE
+    float x = 0;
+    float y = 0;
+    //steady_clock nanoseconds when the event happened, pushInput() stamps it when left at 0
+    uint64_t timestamp = 0;
+};
+
+//Fixed size ring buffer for one producer thread and one consumer thread. Neither side locks or allocates
+class ClayManInputQueue {
+    public:
+        //Capacity is rounded up to a power of two
+        explicit ClayManInputQueue(size_t capacity = 1024);
+
+        //Producer side, returns false when the queue is full and the event was dropped
+        bool push(const ClayManInputEvent& event);
+
+        //Consumer side, returns false when the queue is empty
+        bool pop(ClayManInputEvent& event);
+
+    private:
+        std::vector<ClayManInputEvent> events;
+        size_t mask;
+        //Next slot to pop, written by the consumer only
+        alignas(64) std::atomic<size_t> head = 0;
+        //Next slot to push, written by the producer only
+        alignas(64) std::atomic<size_t> tail = 0;
+};
+
+//One frame's render commands copied by submitFrame(), with text copied too so it stays valid while the next frame is laid out. Image, custom and user data pointers are copied as they are
+struct ClayManFrameSnapshot {
+    std::vector<Clay_RenderCommand> commands;
+    //Text of every TEXT command, their string slices point in here
+    std::vector<char> text;
+    //Counts submitted frames from 1
+    uint64_t frameNumber = 0;
+
+    Clay_RenderCommandArray renderCommands(){
+        return (Clay_RenderCommandArray){(int32_t)commands.size(), (int32_t)commands.size(), commands.data()};
+    }
+};
+
+//What changed in the last frame, filled by updateClayState() and endLayout()
+struct ClayManFrameChanges {
+    //Window size, pointer position or button differ from the previous updateClayState(), or there was a scroll delta
+    bool inputChanged = true;
+    //The render commands differ from the previous frame's
+    bool visualChanged = true;
+    //Scroll momentum is still moving, or a press or release has not settled yet, so the next frame will differ without new input
+    bool animationPending = false;
+    uint64_t inputFingerprint = 0;
+    uint64_t renderFingerprint = 0;
+};
+
+//A parent whose children were sized during layout analysis, accumulated over the analyzed frames. Both axes count
+struct ClayManSizingHotspot {
+    uint32_t elementId = 0;
+    //String ID the element was declared with, empty for generated IDs
+    std::string name;
+    uint32_t frames = 0;
+    uint32_t childCount = 0;
+    uint32_t growChildCount = 0;
+    //Most grow or compress passes in one frame, siblings with many distinct sizes need one pass per size
+    uint32_t maxIterations = 0;
+    uint64_t totalIterations = 0;
+    //Frames its children overflowed an axis it cannot scroll on and were compressed
+    uint32_t compressedFrames = 0;
+    double milliseconds = 0;
+};
+
+//Text children of one parent that missed the text measurement cache during layout analysis
+struct ClayManTextMissHotspot {
+    uint32_t parentId = 0;
+    std::string parentName;
+    uint32_t frames = 0;
+    uint64_t misses = 0;
+    //Most consecutive frames with a miss, text that changes every frame is measured again every frame
+    uint32_t longestStreak = 0;
+};
+
+//Result of getLayoutAnalysis(), hotspots are sorted with the worst first
+struct ClayManLayoutAnalysis {
+    uint32_t frames = 0;
+    double sizingMilliseconds = 0;
+    uint32_t maxDepth = 0;
+    uint32_t deepestElementId = 0;
+    std::string deepestElementName;
+    std::vector<ClayManSizingHotspot> sizing;
+    std::vector<ClayManTextMissHotspot> textMisses;
+};
+
+//Which Clay setting sizes an arena array, see getRecommendedCapacities()
+enum class ClayManCapacity {
+    ELEMENTS,
+    MEASURE_TEXT_CACHE_WORDS,
+    SCROLL_CONTAINERS,
+    FIXED
+};
+
+//Peak usage of one array in the Clay_Context arena, sampled at the end of every endLayout(). Scratch arrays reused during layout calculation are sampled after it and never need more than layoutElements
+struct ClayManArrayUsage {
+    const char* name = nullptr;
+    ClayManCapacity sizedBy = ClayManCapacity::ELEMENTS;
+    int32_t length = 0;
+    int32_t peak = 0;
+    int32_t capacity = 0;
+    size_t elementSize = 0;
+    size_t bytesReserved = 0;
+    //False for hash buckets and other arrays indexed directly, their length and peak stay 0 and they scale with the array they index
+    bool tracksLength = true;
+};
+
+//Settings that fit the peaks seen so far with some headroom, pass them to Clay_SetMax* and Clay_CreateArenaWithCapacityAndMemory before Clay_Initialize
+struct ClayManCapacities {
+    int32_t maxElementCount = 0;
+    int32_t maxMeasureTextCacheWordCount = 0;
+    int32_t maxScrollContainerCount = 0;
+    size_t arenaBytes = 0;
+};
+
 //This class initializes Clay.h layout library, manages it's context, and provides functions for convenience
 class ClayMan {
     public:
@@ -62,7 +250,10 @@ class ClayMan {
         ClayMan(const ClayMan &clayMan);
 
         //Deconstructor
-        ~ClayMan(){}
+        ~ClayMan(){
+            stopPipeline();
+            stopCapture();
+        }
 
         //Takes mouse, window, and time information and passes it to Clay context
         void updateClayState(
@@ -129,13 +320,12 @@ class ClayMan {
         //A self-contained text element, with no children. Takes a string literal.
         template<size_t N>
         void textElement(const char(&text)[N], const Clay_TextElementConfig textElementConfig){
-            Clay_String cs = toClayString(text);
-            Clay__OpenTextElement(
-                cs,
-                Clay__StoreTextElementConfig((Clay__Clay_TextElementConfigWrapper(textElementConfig)).wrapped)
-            );
+            textElement(toClayString(text), textElementConfig);
         }
 
+        //Creates an element whose subtree a backend can cache as one texture (see include/clay_layer.h). Its userData, unless it has its own, and that of descendants without their own is set to &layer so the backend can tell where the subtree ends. Keep userData off the descendants, one with its own userData ends the cached part of the layer (ClayMan warns once). Floating descendants are left out, and a layer nested in another one joins the outer one. Register layer with the backend before rendering.
+        void layerElement(Clay_LayerConfig& layer, Clay_ElementDeclaration configs, std::function<void()> childLambda);
+
         //Convenience function for .sizing layout parameter
         Clay_Sizing fixedSize(const uint32_t w, const uint32_t h);
 
@@ -196,15 +386,30 @@ class ClayMan {
         //Gets clay internal left-mouse-button state this frame
         bool mousePressed();
 
+        //Checks if the pointer is over the element with this precomputed ID (from hashID or getClayElementId). Single probe into the hovered set built in updateClayState()
+        bool pointerOver(const Clay_ElementId id);
+
         bool pointerOver(const Clay_String id);
 
         bool pointerOver(const std::string& id);
 
         template<size_t N>
         bool pointerOver(const char(&id)[N]){
-            return Clay_PointerOver(getClayElementId(toClayString(id)));
+            return pointerOver(getClayElementId(id));
         }
 
+        //Registers event handlers for an element ID, replacing any previous ones. Events are dispatched once per frame from updateClayState()
+        void setEventHandlers(const Clay_ElementId id, const ClayManEventHandlers& handlers);
+
+        //Registers event handlers for an element ID, replacing any previous ones. Events are dispatched once per frame from updateClayState()
+        void setEventHandlers(const std::string& id, const ClayManEventHandlers& handlers);
+
+        //Removes the event handlers registered for an element ID
+        void removeEventHandlers(const Clay_ElementId id);
+
+        //Removes all registered event handlers
+        void clearEventHandlers();
+
         Clay_ElementId getClayElementId(const Clay_String id);
 
         Clay_ElementId getClayElementId(const std::string& id);
@@ -236,6 +441,115 @@ class ClayMan {
         //Gets current frame count, resets at max int32_t
         uint32_t getFramecount();
 
+        //Gets the number of layout elements (text elements included) created since the last beginLayout()
+        uint32_t getElementCount();
+
+        //Writes the recorded layout phases as Chrome trace JSON, open it in Perfetto or chrome://tracing. Tracing is compiled out unless CLAY_TRACE is defined (CMake option CLAYMAN_TRACE), then this returns false
+        bool writeTrace(const std::string& path);
+
+        //Drops the trace events recorded so far
+        void clearTrace();
+
+        //Groups render commands by type, font and image within each scissor and z range, moving a command only past commands it does not overlap. Returns indices into renderCommands in draw order, valid until the next call
+        const std::vector<uint32_t>& reorderRenderCommands(const Clay_RenderCommandArray& renderCommands);
+
+        //Same pass as reorderRenderCommands(), but returns a reordered copy that can be passed to any renderer unchanged. Valid until the next call
+        Clay_RenderCommandArray reorderedRenderCommands(const Clay_RenderCommandArray& renderCommands);
+
+        //Gets the statistics of the last reorder pass
+        const ClayManReorderStats& getReorderStats() const;
+
+        //Gets lookups, hits, misses, evictions, measure calls, characters measured, cached words versus capacity and the time spent measuring since the last reset
+        ClayManMeasureTextStats getMeasureTextStats();
+
+        //Starts or stops timing the measure text function for getMeasureTextStats(). Off by default so measuring does not read the clock twice per call, layout analysis also turns it on while it runs
+        void setMeasureTextTimingEnabled(bool enabled);
+
+        //Sets the text measurement counters and time back to zero
+        void resetMeasureTextStats();
+
+        //Gets the current length, peak length and reserved bytes of every array in the Clay arena. Peaks are updated by endLayout()
+        const std::vector<ClayManArrayUsage>& getMemoryUsage();
+
+        //Gets the smallest settings that hold every peak times headroom (1.25 = 25% spare), and the arena size they need
+        ClayManCapacities getRecommendedCapacities(float headroom = 1.25f);
+
+        //Gets what changed in the last frame
+        const ClayManFrameChanges& getFrameChanges() const {
+            return frameChanges;
+        }
+
+        //When enabled, endLayout() fingerprints the render commands so isIdle() can tell when nothing changed. Off by default, visualChanged stays true while it is off
+        void setIdleDetectionEnabled(bool enabled);
+
+        //True when the last frame had no new input, looked the same as the one before and has no animation pending. The app can then wait for its next event instead of running more frames, unless its own state changed or an image or custom element animates behind the same pointer
+        bool isIdle() const {
+            return !frameChanges.inputChanged && !frameChanges.visualChanged && !frameChanges.animationPending;
+        }
+
+        //When enabled, beginLayout() drains the input queue and calls updateClayState() itself, so do not call it from the app
+        void setInputQueueEnabled(bool enabled);
+
+        //Queues an input event, safe to call from one event thread while the layout thread runs. Returns false when the queue is full
+        bool pushInput(ClayManInputEvent event);
+
+        //Milliseconds between the oldest event drained by the last beginLayout() and the drain, 0 when there was none
+        double getInputLatency() const {
+            return inputLatencyMilliseconds;
+        }
+
+        //Lets submitFrame() and acquireFrame() pass frames between a layout thread and a render thread through two swap buffers
+        void startPipeline();
+
+        //Starts the pipeline and a render thread that calls render for every submitted frame. Clay and ClayMan are not thread safe, render must only draw the commands it is given
+        void startRenderThread(std::function<void(Clay_RenderCommandArray renderCommands)> render);
+
+        //Layout side: copies renderCommands and their text into the free swap buffer and hands it to the render side, so the next frame can be laid out while this one is drawn. Waits while the previous frame has not been acquired, so layout is never more than one frame ahead
+        void submitFrame(const Clay_RenderCommandArray& renderCommands);
+
+        //Render side: releases the frame acquired before and waits for the next submitted one. Returns nullptr once the pipeline is stopped
+        ClayManFrameSnapshot* acquireFrame();
+
+        //Render side: hands the acquired frame back early, acquireFrame() also does this
+        void releaseFrame();
+
+        //Wakes both sides, joins the render thread and drops a frame that was not acquired yet
+        void stopPipeline();
+
+        //Starts or stops layout analysis. While it runs, every parent's sizing is timed and its grow/compress passes counted, nesting depth is tracked and text measurement cache misses are attributed to their parent element
+        void setLayoutAnalysisEnabled(bool enabled);
+
+        //Gets the analysis accumulated since it was enabled or reset, slowest parents and most missed texts first
+        const ClayManLayoutAnalysis& getLayoutAnalysis();
+
+        //Prints the worst count sizing hotspots and text cache misses, the deepest nesting and what to restructure
+        void printLayoutAnalysis(size_t count = 10);
+
+        //Drops the accumulated analysis
+        void resetLayoutAnalysis();
+
+        //Starts recording every frame to a binary file: updateClayState() arguments, each open, configure, close and text call with its declaration, and every text measurement. With storeRenderCommands the render commands of each frame are saved too, so a replay can be checked against them. Start before the first frame, Clay's scroll and text cache state from earlier frames is not captured
+        bool startCapture(const std::string& path, bool storeRenderCommands = true);
+
+        //Finishes the capture file, called by the destructor
+        void stopCapture();
+
+        bool isCapturing() const {
+            return captureFile != nullptr;
+        }
+
+        //Reads the header of a capture file
+        static bool readCaptureInfo(const std::string& path, ClayManCaptureInfo& info);
+
+        //Runs a capture through this ClayMan without a renderer, measuring text with the captured results. Construct ClayMan with the capacities from readCaptureInfo(). With compare, each frame's render commands are compared byte for byte with the captured ones
+        bool replayCapture(const std::string& path, ClayManReplayResult& result, bool compare = true);
+
+        //Prints getMemoryUsage() and getRecommendedCapacities() as a table
+        void printMemoryUsage(float headroom = 1.25f);
+
+        //Restarts peak tracking from the current lengths
+        void resetMemoryPeaks();
+
     ////////////////////////////////////////////////////////////private//////////////////////////////////////////////////////////////
     private:
         //One-shot for console warning
@@ -244,6 +558,12 @@ class ClayMan {
         //One-shot for console warning
         bool warnedAboutUnderflow = false;
 
+        //One-shot for console warning
+        bool warnedAboutLayerUserData = false;
+
+        //Warns once that a descendant's own userData splits the layer it is in
+        void warnAboutLayerUserData();
+
         uint32_t windowWidth;
         uint32_t windowHeight;
         uint32_t framecount = 0;
@@ -259,6 +579,80 @@ class ClayMan {
 
         //Tracks the heiarchy depth of the current element in the layout
         uint32_t openElementCount = 0;
+
+        //Must be a power of two, and should be at least double the expected hover depth
+        static constexpr size_t hoveredIdSetCapacity = 256;
+
+        //Open-addressed set of element IDs under the pointer this frame, 0 marks an empty slot
+        uint32_t hoveredIdSet[hoveredIdSetCapacity] = {};
+
+        //Number of IDs in hoveredIdSet
+        size_t hoveredIdCount = 0;
+
+        //Set when more IDs are hovered than the set can hold, pointerOver() then falls back to Clay_PointerOver
+        bool hoveredIdSetOverflowed = false;
+
+        //Rebuilds hoveredIdSet from Clay's pointerOverIds, called after Clay_SetPointerState
+        void rebuildHoveredIdSet();
+
+        //Probes an open-addressed set of hoveredIdSetCapacity slots, id must not be 0
+        static bool idSetContains(const uint32_t* set, uint32_t id);
+
+        //Adds id to an open-addressed set of hoveredIdSetCapacity slots, returns false if it was already there
+        static bool idSetInsert(uint32_t* set, uint32_t id);
+
+        //Event handlers keyed by element ID
+        std::unordered_map<uint32_t, ClayManEventHandlers> eventHandlers;
+
+        //Hovered IDs from the previous frame, diffed against hoveredIdSet for enter/leave edges
+        std::vector<Clay_ElementId> previousHoveredIds;
+
+        //Hovered IDs with handlers this frame, swapped into previousHoveredIds so neither allocates once warm
+        std::vector<Clay_ElementId> hoveredIds;
+
+        //previousHoveredIds as an open-addressed set, for the enter edges
+        uint32_t previousHoveredIdSet[hoveredIdSetCapacity] = {};
+
+        //Set when previousHoveredIds is too long for previousHoveredIdSet, wasHovered() then scans the vector
+        bool previousHoveredIdSetOverflowed = false;
+
+        //Whether id was hovered and had handlers last frame
+        bool wasHovered(const Clay_ElementId id);
+
+        //IDs with handlers that were under the pointer when it was pressed, for click and drag
+        std::vector<Clay_ElementId> pressedIds;
+
+        //Pointer position from the previous frame, for drag deltas
+        Clay_Vector2 previousPointerPosition = {};
+
+        //Computes hover and pointer edges for this frame and calls the registered handlers, called after rebuildHoveredIdSet
+        void dispatchEvents();
+
+        ClayManInputQueue inputQueue;
+        bool inputQueueEnabled = false;
+
+        //Pointer state built up from queued events across frames
+        Clay_Vector2 queuedPointerPosition = {};
+        bool queuedPointerDown = false;
+
+        //A press was replayed from the queue this frame, even if it was released again before layout
+        bool queuedPressThisFrame = false;
+
+        std::chrono::steady_clock::time_point lastInputDrain = {};
+        double inputLatencyMilliseconds = 0;
+
+        //Replays the queued events and calls updateClayState(), called by beginLayout() when the queue is enabled
+        void drainInputQueue();
+
+        //Calls one handler of an element if it is registered, a copy is called so handlers may change registrations
+        template<typename F, typename... Args>
+        void callEventHandler(const Clay_ElementId id, F ClayManEventHandlers::*handler, Args... args){
+            auto it = eventHandlers.find(id.id);
+            if(it != eventHandlers.end() && it->second.*handler){
+                F fn = it->second.*handler;
+                fn(id, args...);
+            }
+        }
         
         //Resets index tracker for string arena to 0
         void resetStringArenaIndex() {
@@ -283,8 +677,149 @@ class ClayMan {
             return startPtr;
         }
 
+        //A run of commands sharing one state inside a reorder segment, commands are linked through reorderNext
+        struct ReorderBatch {
+            Clay_RenderCommandType commandType;
+            uint16_t fontId;
+            void* imageData;
+            Clay_BoundingBox bounds;
+            uint32_t first;
+            uint32_t last;
+        };
+
+        //How many batches back a command may move, bounds the pass to linear time on long segments
+        static constexpr size_t reorderWindow = 32;
+
+        //Reused between frames so the pass does not allocate after warm-up
+        std::vector<uint32_t> reorderIndices;
+        std::vector<uint32_t> reorderNext;
+        std::vector<ReorderBatch> reorderBatches;
+        std::vector<Clay_RenderCommand> reorderedCommands;
+        ClayManReorderStats reorderStats;
+
+        //Appends the batches of the current segment to reorderIndices and clears them
+        void flushReorderBatches();
+
+        //Counts state changes and draw calls of renderCommands drawn in the order of indices
+        static void countDrawStates(const Clay_RenderCommandArray& renderCommands, const std::vector<uint32_t>& indices, uint32_t& stateChanges, uint32_t& drawCalls);
+
+        //One entry per Clay_Context array, filled by the first updateMemoryUsage()
+        std::vector<ClayManArrayUsage> memoryUsage;
+
+        //Samples the array lengths of the current Clay context into memoryUsage
+        void updateMemoryUsage();
+
+        //The layer elements opened by this point are tagged with, nullptr outside of a layer
+        void* layerTag = nullptr;
+
+        //An element that changed layerTag, it is restored when that element closes
+        struct LayerTagScope {
+            uint32_t depth;
+            void* previousTag;
+        };
+        std::vector<LayerTagScope> layerTagScopes;
+
+        //Changes layerTag for the children of the element opened last
+        void pushLayerTag(void* tag){
+            layerTagScopes.push_back({openElementCount, layerTag});
+            layerTag = tag;
+        }
+
         void applyElementConfigs(const Clay_ElementDeclaration& configs);
 
+        ClayManFrameChanges frameChanges;
+
+        //Swap buffers of the pipeline, ready is the submitted frame waiting for the render side and acquired the one it draws, -1 for none
+        ClayManFrameSnapshot pipelineFrames[2];
+        int pipelineReady = -1;
+        int pipelineAcquired = -1;
+        bool pipelineRunning = false;
+        uint64_t submittedFrameCount = 0;
+        std::mutex pipelineMutex;
+        std::condition_variable pipelineCondition;
+        std::thread renderThread;
+
+        //Fills frameChanges.renderFingerprint and visualChanged, called by endLayout() while idle detection is enabled
+        void fingerprintRenderCommands(const Clay_RenderCommandArray& renderCommands);
+
+        bool idleDetectionEnabled = false;
+        bool measureTextTimingEnabled = false;
+        bool layoutAnalysisEnabled = false;
+        uint32_t analyzedFrames = 0;
+        double analyzedSizingMilliseconds = 0;
+        std::chrono::steady_clock::time_point sizingStart;
+
+        //Per parent totals plus what the current frame added, so per frame maxima can be taken
+        struct SizingAccumulator {
+            ClayManSizingHotspot hotspot;
+            uint32_t lastFrame = UINT32_MAX;
+            uint32_t frameIterations = 0;
+        };
+        std::unordered_map<uint32_t, SizingAccumulator> sizingAccumulators;
+
+        struct TextMissAccumulator {
+            ClayManTextMissHotspot hotspot;
+            uint32_t lastFrame = UINT32_MAX;
+            uint32_t streak = 0;
+        };
+        std::unordered_map<uint32_t, TextMissAccumulator> textMissAccumulators;
+
+        uint32_t frameMaxDepth = 0;
+        uint32_t frameDeepestElementId = 0;
+        ClayManLayoutAnalysis layoutAnalysis;
+
+        //Bound with Clay_SetSizingAnalysisFunction() while analysis is enabled, userData is the ClayMan
+        static void sizingAnalysisHook(Clay_SizingAnalysis analysis, void* userData);
+
+        //Folds the current frame's depth into layoutAnalysis, called by endLayout()
+        void finishLayoutAnalysisFrame();
+
+        //Configures the element opened last, every declaration goes through here so captures see it
+        void configureOpenElement(const Clay_ElementDeclaration& configs);
+
+        //Open capture file, nullptr when not capturing
+        FILE* captureFile = nullptr;
+
+        //Ops of the current frame, written out by endLayout()
+        std::vector<uint8_t> captureBuffer;
+
+        //Measurements already in the capture, keyed like the replay looks them up
+        std::unordered_set<std::string> capturedMeasurements;
+
+        bool captureRenderCommands = false;
+        uint32_t capturedFrames = 0;
+
+        //Set by startCapture(), the next beginLayout() records Clay's scroll containers so a capture can start mid-session
+        bool captureScrollStatePending = false;
+
+        //Writes the scroll container state Clay carries between frames into captureBuffer
+        void captureScrollState();
+
+        //Appends raw bytes to captureBuffer
+        void captureBytes(const void* data, size_t size){
+            const uint8_t* bytes = (const uint8_t*)data;
+            captureBuffer.insert(captureBuffer.end(), bytes, bytes + size);
+        }
+
+        //Appends a string with the address it was passed at, so the replay can give equal addresses equal storage
+        void captureString(const char* chars, int32_t length){
+            uint64_t address = (uint64_t)(uintptr_t)chars;
+            captureBytes(&address, sizeof(address));
+            captureBytes(&length, sizeof(length));
+            if(length > 0){
+                captureBytes(chars, (size_t)length);
+            }
+        }
+
+        //Writes the frame's ops, its command count and optionally its render commands to the capture file
+        void captureFrame(const Clay_RenderCommandArray& renderCommands);
+
+        //Called by measureTextHook() for every measurement while capturing
+        void captureMeasurement(Clay_StringSlice text, const Clay_TextElementConfig* config, Clay_Dimensions dimensions);
+
+        //Forwards to the measure text function the app registered, timing and capturing it. Installed by beginLayout()
+        static Clay_Dimensions measureTextHook(Clay_StringSlice text, Clay_TextElementConfig *config, void* userData);
+
         void closeAllElements();
 
         //Clay_ErrorHandler
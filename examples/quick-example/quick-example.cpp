@@ -136,6 +136,7 @@ int main(void) {
 
     //Initialize ClayMan instance
     ClayMan clayMan(1024, 786, Raylib_MeasureText, fonts);
+    clayMan.setIdleDetectionEnabled(true);
 
     //Initialize Raylib
     Clay_Raylib_Initialize(
@@ -180,6 +181,13 @@ int main(void) {
         //Call endLayout() to get Clay_RenderCommandArray
         //Which, in-turn, get's passed to the renderer, along with the fonts, to be drawn
         Clay_Raylib_Render(clayMan.endLayout(), fonts); 
+
+        //Nothing moved and nothing will without new input, so let EndDrawing() sleep until the next event
+        if(clayMan.isIdle()){
+            EnableEventWaiting();
+        } else {
+            DisableEventWaiting();
+        }
         
         EndDrawing(); //Rayblib native command
     }
@@ -85,6 +85,7 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[]){
     SDL_GetWindowSize(state->window, &width, &height);
 
     state->clayMan = ClayMan(width, height, SDL_MeasureText, state->rendererData.fonts);
+    state->clayMan.setIdleDetectionEnabled(true);
 
     state->width = width;
     state->height = height;
@@ -223,6 +224,9 @@ SDL_AppResult SDL_AppIterate(void *appstate){
     state->deltaTime = (double)((state->NOW - state->LAST)*1000 / (double)SDL_GetPerformanceFrequency() );
 
     state->clayMan.updateClayState(state->width, state->height, state->mouseX, state->mouseY, state->scrollX, state->scrollY, state->deltaTime, state->mouseDown); 
+    //Wheel events are deltas, consume them so an idle frame sees no scroll
+    state->scrollX = 0;
+    state->scrollY = 0;
 
     myActions(state);
 
@@ -235,6 +239,9 @@ SDL_AppResult SDL_AppIterate(void *appstate){
     SDL_Clay_RenderClayCommands(&state->rendererData, &state->renderCommands);
     SDL_RenderPresent(state->rendererData.renderer);
 
+    //Nothing moved and nothing will without new input, so only iterate again once an event arrives
+    SDL_SetHint(SDL_HINT_MAIN_CALLBACK_RATE, state->clayMan.isIdle() ? "waitevent" : "0");
+
     return SDL_APP_CONTINUE;
 }
 
@@ -626,6 +626,47 @@ typedef struct {
     bool found;
 } Clay_ScrollContainerData;
 
+// Counters for the internal text measurement cache, accumulated since Clay_Initialize() or Clay_ResetMeasureTextCacheStats().
+typedef struct {
+    // Calls to the cache. A text element looks up its measurement when it is declared and again when its lines are wrapped.
+    uint64_t lookups;
+    // Lookups that found the text already measured.
+    uint64_t hits;
+    // Lookups that measured the text with the measure text function.
+    uint64_t misses;
+    // Entries dropped because their text was not seen for a few frames.
+    uint64_t evictions;
+    // Calls to the measure text function, including the space width measured for every miss and every wrapped text element.
+    uint64_t measureCalls;
+    // Characters passed to the measure text function.
+    uint64_t charactersMeasured;
+    // Measured words currently held and the maximum, see Clay_SetMaxMeasureTextCacheWordCount().
+    int32_t wordsCached;
+    int32_t wordCapacity;
+    // Measured text elements currently held and the maximum, see Clay_SetMaxElementCount().
+    int32_t entriesCached;
+    int32_t entryCapacity;
+} Clay_MeasureTextCacheStats;
+
+// Reported around the sizing of each parent's children on each axis, see Clay_SetSizingAnalysisFunction().
+typedef struct {
+    // The parent whose children are being sized.
+    uint32_t elementId;
+    bool xAxis;
+    // False when the parent is about to be sized, true once it is done and the counts below are filled in.
+    bool finished;
+    // True when this axis is the parent's layout direction, the only case where children are grown or compressed.
+    bool alongLayoutAxis;
+    // True when the children overflowed a parent that cannot scroll on this axis and had to be compressed.
+    bool compressedOverflow;
+    int32_t childCount;
+    int32_t growChildCount;
+    // Children that could be grown or compressed when distribution started.
+    int32_t resizableChildCount;
+    // Passes of the grow or compress loop. Each pass touches every resizable child, GROW siblings with many distinct sizes need many passes.
+    int32_t iterations;
+} Clay_SizingAnalysis;
+
 // Bounding box and other data for a specific UI element.
 typedef struct {
     // The rectangle that encloses this UI element, with the position relative to the root of the layout.
@@ -760,6 +801,8 @@ typedef CLAY_PACKED_ENUM {
     CLAY_ERROR_TYPE_PERCENTAGE_OVER_1,
     // Clay encountered an internal error. It would be wonderful if you could report this so we can fix it!
     CLAY_ERROR_TYPE_INTERNAL_ERROR,
+    // Clay ran out of capacity in its internal array for storing scroll container state. This limit can be increased with Clay_SetMaxScrollContainerCount().
+    CLAY_ERROR_TYPE_SCROLL_CONTAINERS_CAPACITY_EXCEEDED,
 } Clay_ErrorType;
 
 // Data to identify the error that clay has encountered.
@@ -773,6 +816,7 @@ typedef struct {
     // CLAY_ERROR_TYPE_FLOATING_CONTAINER_PARENT_NOT_FOUND - A floating element was declared using CLAY_ATTACH_TO_ELEMENT_ID and either an invalid .parentId was provided or no element with the provided .parentId was found.
     // CLAY_ERROR_TYPE_PERCENTAGE_OVER_1 - An element was declared that using CLAY_SIZING_PERCENT but the percentage value was over 1. Percentage values are expected to be in the 0-1 range.
     // CLAY_ERROR_TYPE_INTERNAL_ERROR - Clay encountered an internal error. It would be wonderful if you could report this so we can fix it!
+    // CLAY_ERROR_TYPE_SCROLL_CONTAINERS_CAPACITY_EXCEEDED - Clay ran out of capacity in its internal array for storing scroll container state. This limit can be increased with Clay_SetMaxScrollContainerCount().
     Clay_ErrorType errorType;
     // A string containing human-readable error text that explains the error in more detail.
     Clay_String errorText;
@@ -876,9 +920,21 @@ CLAY_DLL_EXPORT int32_t Clay_GetMaxMeasureTextCacheWordCount(void);
 // Modifies the maximum number of measured "words" (whitespace seperated runs of characters) that Clay can store in its internal text measurement cache.
 // This may require reallocating additional memory, and re-calling Clay_Initialize();
 CLAY_DLL_EXPORT void Clay_SetMaxMeasureTextCacheWordCount(int32_t maxMeasureTextCacheWordCount);
+// Returns the maximum number of scroll containers whose scroll state Clay can retain across frames.
+CLAY_DLL_EXPORT int32_t Clay_GetMaxScrollContainerCount(void);
+// Modifies the maximum number of scroll containers whose scroll state Clay can retain across frames.
+// This may require reallocating additional memory, and re-calling Clay_Initialize();
+CLAY_DLL_EXPORT void Clay_SetMaxScrollContainerCount(int32_t maxScrollContainerCount);
 // Resets Clay's internal text measurement cache, useful if memory to represent strings is being re-used.
 // Similar behaviour can be achieved on an individual text element level by using Clay_TextElementConfig.hashStringContents
 CLAY_DLL_EXPORT void Clay_ResetMeasureTextCache(void);
+// Binds a callback that Clay calls before and after sizing the children of every parent on each axis, to find slow layouts.
+// Pass NULL to turn it off again. It is not called while unset, which is the default.
+CLAY_DLL_EXPORT void Clay_SetSizingAnalysisFunction(void (*sizingAnalysisFunction)(Clay_SizingAnalysis analysis, void *userData), void *userData);
+// Returns the counters and current occupancy of the text measurement cache.
+CLAY_DLL_EXPORT Clay_MeasureTextCacheStats Clay_GetMeasureTextCacheStats(void);
+// Sets the counters returned by Clay_GetMeasureTextCacheStats() back to zero. The cache itself is not changed.
+CLAY_DLL_EXPORT void Clay_ResetMeasureTextCacheStats(void);
 
 // Internal API functions required by macros ----------------------
 
@@ -894,6 +950,19 @@ CLAY_DLL_EXPORT uint32_t Clay__GetParentElementId(void);
 extern Clay_Color Clay__debugViewHighlightColor;
 extern uint32_t Clay__debugViewWidth;
 
+// Tracing hooks around the layout phases. Defining CLAY_TRACE routes them to Clay__TraceBegin / Clay__TraceEnd, which the
+// embedding application implements (ClayMan records them into a ring buffer). Otherwise they compile to nothing.
+// Names must be string literals, only the pointer is kept.
+#ifdef CLAY_TRACE
+CLAY_DLL_EXPORT void Clay__TraceBegin(const char *name);
+CLAY_DLL_EXPORT void Clay__TraceEnd(const char *name);
+#define CLAY__TRACE_BEGIN(name) Clay__TraceBegin(name)
+#define CLAY__TRACE_END(name) Clay__TraceEnd(name)
+#else
+#define CLAY__TRACE_BEGIN(name) ((void)0)
+#define CLAY__TRACE_END(name) ((void)0)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -986,6 +1055,7 @@ CLAY__ARRAY_DEFINE_FUNCTIONS(typeName, arrayName)   \
 Clay_Context *Clay__currentContext;
 int32_t Clay__defaultMaxElementCount = 8192;
 int32_t Clay__defaultMaxMeasureTextWordCacheCount = 16384;
+int32_t Clay__defaultMaxScrollContainerCount = 256;
 
 void Clay__ErrorHandlerFunctionDefault(Clay_ErrorData errorText) {
     (void) errorText;
@@ -998,6 +1068,7 @@ typedef struct {
     bool maxElementsExceeded;
     bool maxRenderCommandsExceeded;
     bool maxTextMeasureCacheExceeded;
+    bool maxScrollContainersExceeded;
     bool textMeasurementFunctionNotSet;
 } Clay_BooleanWarnings;
 
@@ -1071,6 +1142,28 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay_ElementConfig, Clay__ElementConfigArray)
 
+typedef struct {
+    int32_t startOffset;
+    int32_t length;
+    float width;
+    int32_t next;
+} Clay__MeasuredWord;
+
+CLAY__ARRAY_DEFINE(Clay__MeasuredWord, Clay__MeasuredWordArray)
+
+typedef struct {
+    Clay_Dimensions unwrappedDimensions;
+    int32_t measuredWordsStartIndex;
+    float minWidth;
+    bool containsNewlines;
+    // Hash map data
+    uint32_t id;
+    int32_t nextIndex;
+    uint32_t generation;
+} Clay__MeasureTextCacheItem;
+
+CLAY__ARRAY_DEFINE(Clay__MeasureTextCacheItem, Clay__MeasureTextCacheItemArray)
+
 typedef struct {
     Clay_Dimensions dimensions;
     Clay_String line;
@@ -1083,6 +1176,8 @@ typedef struct {
     Clay_Dimensions preferredDimensions;
     int32_t elementIndex;
     Clay__WrappedTextLineArraySlice wrappedLines;
+    bool wrapDeferred; // Wrapping was skipped because the text was entirely clipped last frame, see Clay__CalculateFinalLayout
+    Clay__MeasureTextCacheItem *measureTextCacheItem; // Looked up when wrapping was deferred, reused if the text becomes visible
 } Clay__TextElementData;
 
 CLAY__ARRAY_DEFINE(Clay__TextElementData, Clay__TextElementDataArray)
@@ -1140,32 +1235,15 @@ typedef struct { // todo get this struct into a single cache line
     uint32_t generation;
     uint32_t idAlias;
     Clay__DebugElementData *debugData;
+    // Result of the last text wrap for text elements, reused while the text stays entirely clipped
+    uint32_t wrappedTextId;
+    float wrappedTextWidth;
+    float wrappedTextHeight;
+    bool wrappedTextClipped;
 } Clay_LayoutElementHashMapItem;
 
 CLAY__ARRAY_DEFINE(Clay_LayoutElementHashMapItem, Clay__LayoutElementHashMapItemArray)
 
-typedef struct {
-    int32_t startOffset;
-    int32_t length;
-    float width;
-    int32_t next;
-} Clay__MeasuredWord;
-
-CLAY__ARRAY_DEFINE(Clay__MeasuredWord, Clay__MeasuredWordArray)
-
-typedef struct {
-    Clay_Dimensions unwrappedDimensions;
-    int32_t measuredWordsStartIndex;
-    float minWidth;
-    bool containsNewlines;
-    // Hash map data
-    uint32_t id;
-    int32_t nextIndex;
-    uint32_t generation;
-} Clay__MeasureTextCacheItem;
-
-CLAY__ARRAY_DEFINE(Clay__MeasureTextCacheItem, Clay__MeasureTextCacheItemArray)
-
 typedef struct {
     Clay_LayoutElement *layoutElement;
     Clay_Vector2 position;
@@ -1187,6 +1265,7 @@ CLAY__ARRAY_DEFINE(Clay__LayoutElementTreeRoot, Clay__LayoutElementTreeRootArray
 struct Clay_Context {
     int32_t maxElementCount;
     int32_t maxMeasureTextCacheWordCount;
+    int32_t maxScrollContainerCount;
     bool warningsEnabled;
     Clay_ErrorHandler errorHandler;
     Clay_BooleanWarnings booleanWarnings;
@@ -1230,6 +1309,8 @@ struct Clay_Context {
     Clay__WrappedTextLineArray wrappedTextLines;
     Clay__LayoutElementTreeNodeArray layoutElementTreeNodeArray1;
     Clay__LayoutElementTreeRootArray layoutElementTreeRoots;
+    Clay__LayoutElementTreeRootArray layoutElementTreeRootsSortBuffer;
+    bool layoutElementTreeRootsNeedSort; // Set when a root is registered with a lower zIndex than the root before it
     Clay__LayoutElementHashMapItemArray layoutElementsHashMapInternal;
     Clay__int32_tArray layoutElementsHashMap;
     Clay__MeasureTextCacheItemArray measureTextHashMapInternal;
@@ -1240,9 +1321,15 @@ struct Clay_Context {
     Clay__int32_tArray openClipElementStack;
     Clay__ElementIdArray pointerOverIds;
     Clay__ScrollContainerDataInternalArray scrollContainerDatas;
+    Clay__int32_tArray scrollContainerHashMap; // Open addressed, power of two capacity, -1 marks an empty slot
+    uint32_t cullingClipElementId; // Clip element whose visible bounds are cached below, 0 if none
+    Clay_BoundingBox cullingVisibleBounds;
     Clay__boolArray treeNodeVisited;
     Clay__charArray dynamicStringData;
     Clay__DebugElementDataArray debugElementData;
+    Clay_MeasureTextCacheStats measureTextCacheStats;
+    void (*sizingAnalysisFunction)(Clay_SizingAnalysis analysis, void *userData);
+    void *sizingAnalysisUserData;
 };
 
 Clay_Context* Clay__Context_Allocate_Arena(Clay_Arena *arena) {
@@ -1284,6 +1371,55 @@ uint32_t Clay__GetParentElementId(void) {
     return Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&context->openLayoutElementStack, context->openLayoutElementStack.length - 2))->id;
 }
 
+int32_t Clay__GetScrollContainerHashMapSlot(uint32_t elementId) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t mask = (uint32_t)context->scrollContainerHashMap.capacity - 1;
+    uint32_t slot = elementId & mask;
+    // The map is kept at most half full, so there is always an empty slot to stop at
+    while (context->scrollContainerHashMap.internalArray[slot] != -1) {
+        if (context->scrollContainerDatas.internalArray[context->scrollContainerHashMap.internalArray[slot]].elementId == elementId) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return (int32_t)slot;
+}
+
+Clay__ScrollContainerDataInternal* Clay__GetScrollContainerData(uint32_t elementId) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t index = context->scrollContainerHashMap.internalArray[Clay__GetScrollContainerHashMapSlot(elementId)];
+    return index == -1 ? CLAY__NULL : &context->scrollContainerDatas.internalArray[index];
+}
+
+Clay__ScrollContainerDataInternal* Clay__AddScrollContainerData(Clay__ScrollContainerDataInternal item) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->scrollContainerDatas.length == context->scrollContainerDatas.capacity) {
+        if (!context->booleanWarnings.maxScrollContainersExceeded) {
+            context->booleanWarnings.maxScrollContainersExceeded = true;
+            context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                .errorType = CLAY_ERROR_TYPE_SCROLL_CONTAINERS_CAPACITY_EXCEEDED,
+                .errorText = CLAY_STRING("Clay ran out of capacity while attempting to retain scroll container state. Try using Clay_SetMaxScrollContainerCount() with a higher value."),
+                .userData = context->errorHandler.userData });
+        }
+        return &Clay__ScrollContainerDataInternal_DEFAULT;
+    }
+    int32_t slot = Clay__GetScrollContainerHashMapSlot(item.elementId);
+    context->scrollContainerHashMap.internalArray[slot] = context->scrollContainerDatas.length;
+    return Clay__ScrollContainerDataInternalArray_Add(&context->scrollContainerDatas, item);
+}
+
+// Called after scroll datas have been removed with swapback, which invalidates their indices
+void Clay__RebuildScrollContainerHashMap(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t i = 0; i < context->scrollContainerHashMap.capacity; ++i) {
+        context->scrollContainerHashMap.internalArray[i] = -1;
+    }
+    for (int32_t i = 0; i < context->scrollContainerDatas.length; ++i) {
+        int32_t slot = Clay__GetScrollContainerHashMapSlot(context->scrollContainerDatas.internalArray[i].elementId);
+        context->scrollContainerHashMap.internalArray[slot] = i;
+    }
+}
+
 Clay_LayoutConfig * Clay__StoreLayoutConfig(Clay_LayoutConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &CLAY_LAYOUT_DEFAULT : Clay__LayoutConfigArray_Add(&Clay_GetCurrentContext()->layoutConfigs, config); }
 Clay_TextElementConfig * Clay__StoreTextElementConfig(Clay_TextElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_TextElementConfig_DEFAULT : Clay__TextElementConfigArray_Add(&Clay_GetCurrentContext()->textElementConfigs, config); }
 Clay_ImageElementConfig * Clay__StoreImageElementConfig(Clay_ImageElementConfig config) {  return Clay_GetCurrentContext()->booleanWarnings.maxElementsExceeded ? &Clay_ImageElementConfig_DEFAULT : Clay__ImageElementConfigArray_Add(&Clay_GetCurrentContext()->imageElementConfigs, config); }
@@ -1409,6 +1545,13 @@ Clay__MeasuredWord *Clay__AddMeasuredWord(Clay__MeasuredWord word, Clay__Measure
     }
 }
 
+Clay_Dimensions Clay__MeasureTextCounted(Clay_StringSlice text, Clay_TextElementConfig *config) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->measureTextCacheStats.measureCalls++;
+    context->measureTextCacheStats.charactersMeasured += (uint64_t)text.length;
+    return Clay__MeasureText(text, config, context->measureTextUserData);
+}
+
 Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_TextElementConfig *config) {
     Clay_Context* context = Clay_GetCurrentContext();
     #ifndef CLAY_WASM
@@ -1423,6 +1566,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         return &Clay__MeasureTextCacheItem_DEFAULT;
     }
     #endif
+    context->measureTextCacheStats.lookups++;
     uint32_t id = Clay__HashTextWithConfig(text, config);
     uint32_t hashBucket = id % (context->maxMeasureTextCacheWordCount / 32);
     int32_t elementIndexPrevious = 0;
@@ -1431,10 +1575,12 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         Clay__MeasureTextCacheItem *hashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndex);
         if (hashEntry->id == id) {
             hashEntry->generation = context->generation;
+            context->measureTextCacheStats.hits++;
             return hashEntry;
         }
         // This element hasn't been seen in a few frames, delete the hash map item
         if (context->generation - hashEntry->generation > 2) {
+            context->measureTextCacheStats.evictions++;
             // Add all the measured words that were included in this measurement to the freelist
             int32_t nextWordIndex = hashEntry->measuredWordsStartIndex;
             while (nextWordIndex != -1) {
@@ -1459,6 +1605,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         }
     }
 
+    context->measureTextCacheStats.misses++;
     int32_t newItemIndex = 0;
     Clay__MeasureTextCacheItem newCacheItem = { .measuredWordsStartIndex = -1, .id = id, .generation = context->generation };
     Clay__MeasureTextCacheItem *measured = NULL;
@@ -1487,7 +1634,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     float lineWidth = 0;
     float measuredWidth = 0;
     float measuredHeight = 0;
-    float spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config, context->measureTextUserData).width;
+    float spaceWidth = Clay__MeasureTextCounted(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config).width;
     Clay__MeasuredWord tempWord = { .next = -1 };
     Clay__MeasuredWord *previousWord = &tempWord;
     while (end < text->length) {
@@ -1504,7 +1651,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         char current = text->chars[end];
         if (current == ' ' || current == '\n') {
             int32_t length = end - start;
-            Clay_Dimensions dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = length, .chars = &text->chars[start], .baseChars = text->chars }, config, context->measureTextUserData);
+            Clay_Dimensions dimensions = Clay__MeasureTextCounted(CLAY__INIT(Clay_StringSlice) { .length = length, .chars = &text->chars[start], .baseChars = text->chars }, config);
             measured->minWidth = CLAY__MAX(dimensions.width, measured->minWidth);
             measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
             if (current == ' ') {
@@ -1527,7 +1674,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         end++;
     }
     if (end - start > 0) {
-        Clay_Dimensions dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = end - start, .chars = &text->chars[start], .baseChars = text->chars }, config, context->measureTextUserData);
+        Clay_Dimensions dimensions = Clay__MeasureTextCounted(CLAY__INIT(Clay_StringSlice) { .length = end - start, .chars = &text->chars[start], .baseChars = text->chars }, config);
         Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = end - start, .width = dimensions.width, .next = -1 }, previousWord);
         lineWidth += dimensions.width;
         measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
@@ -1950,6 +2097,9 @@ void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *declaration) {
             int32_t currentElementIndex = Clay__int32_tArray_GetValue(&context->openLayoutElementStack, context->openLayoutElementStack.length - 1);
             Clay__int32_tArray_Set(&context->layoutElementClipElementIds, currentElementIndex, clipElementId);
             Clay__int32_tArray_Add(&context->openClipElementStack, clipElementId);
+            if (context->layoutElementTreeRoots.length > 0 && floatingConfig.zIndex < context->layoutElementTreeRoots.internalArray[context->layoutElementTreeRoots.length - 1].zIndex) {
+                context->layoutElementTreeRootsNeedSort = true;
+            }
             Clay__LayoutElementTreeRootArray_Add(&context->layoutElementTreeRoots, CLAY__INIT(Clay__LayoutElementTreeRoot) {
                     .layoutElementIndex = Clay__int32_tArray_GetValue(&context->openLayoutElementStack, context->openLayoutElementStack.length - 1),
                     .parentId = floatingConfig.parentId,
@@ -1973,17 +2123,12 @@ void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *declaration) {
         Clay__AttachElementConfig(CLAY__INIT(Clay_ElementConfigUnion) { .scrollElementConfig = Clay__StoreScrollElementConfig(declaration->scroll) }, CLAY__ELEMENT_CONFIG_TYPE_SCROLL);
         Clay__int32_tArray_Add(&context->openClipElementStack, (int)openLayoutElement->id);
         // Retrieve or create cached data to track scroll position across frames
-        Clay__ScrollContainerDataInternal *scrollOffset = CLAY__NULL;
-        for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
-            Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-            if (openLayoutElement->id == mapping->elementId) {
-                scrollOffset = mapping;
-                scrollOffset->layoutElement = openLayoutElement;
-                scrollOffset->openThisFrame = true;
-            }
-        }
-        if (!scrollOffset) {
-            scrollOffset = Clay__ScrollContainerDataInternalArray_Add(&context->scrollContainerDatas, CLAY__INIT(Clay__ScrollContainerDataInternal){.layoutElement = openLayoutElement, .scrollOrigin = {-1,-1}, .elementId = openLayoutElement->id, .openThisFrame = true});
+        Clay__ScrollContainerDataInternal *scrollOffset = Clay__GetScrollContainerData(openLayoutElement->id);
+        if (scrollOffset) {
+            scrollOffset->layoutElement = openLayoutElement;
+            scrollOffset->openThisFrame = true;
+        } else {
+            scrollOffset = Clay__AddScrollContainerData(CLAY__INIT(Clay__ScrollContainerDataInternal){.layoutElement = openLayoutElement, .scrollOrigin = {-1,-1}, .elementId = openLayoutElement->id, .openThisFrame = true});
         }
         if (context->externalScrollHandlingEnabled) {
             scrollOffset->scrollPosition = Clay__QueryScrollOffset(scrollOffset->elementId, context->queryScrollOffsetUserData);
@@ -2022,6 +2167,8 @@ void Clay__InitializeEphemeralMemory(Clay_Context* context) {
     context->wrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementTreeNodeArray1 = Clay__LayoutElementTreeNodeArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementTreeRoots = Clay__LayoutElementTreeRootArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementTreeRootsSortBuffer = Clay__LayoutElementTreeRootArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementTreeRootsNeedSort = false;
     context->layoutElementChildren = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->openLayoutElementStack = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->textElementData = Clay__TextElementDataArray_Allocate_Arena(maxElementCount, arena);
@@ -2041,7 +2188,14 @@ void Clay__InitializePersistentMemory(Clay_Context* context) {
     int32_t maxMeasureTextCacheWordCount = context->maxMeasureTextCacheWordCount;
     Clay_Arena *arena = &context->internalArena;
 
-    context->scrollContainerDatas = Clay__ScrollContainerDataInternalArray_Allocate_Arena(10, arena);
+    int32_t maxScrollContainerCount = context->maxScrollContainerCount;
+    int32_t scrollContainerHashMapCapacity = 1;
+    while (scrollContainerHashMapCapacity < maxScrollContainerCount * 2) {
+        scrollContainerHashMapCapacity *= 2;
+    }
+
+    context->scrollContainerDatas = Clay__ScrollContainerDataInternalArray_Allocate_Arena(maxScrollContainerCount, arena);
+    context->scrollContainerHashMap = Clay__int32_tArray_Allocate_Arena(scrollContainerHashMapCapacity, arena);
     context->layoutElementsHashMapInternal = Clay__LayoutElementHashMapItemArray_Allocate_Arena(maxElementCount, arena);
     context->layoutElementsHashMap = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
     context->measureTextHashMapInternal = Clay__MeasureTextCacheItemArray_Allocate_Arena(maxElementCount, arena);
@@ -2092,6 +2246,10 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
         for (int32_t i = 0; i < bfsBuffer.length; ++i) {
             int32_t parentIndex = Clay__int32_tArray_GetValue(&bfsBuffer, i);
             Clay_LayoutElement *parent = Clay_LayoutElementArray_Get(&context->layoutElements, parentIndex);
+            Clay_SizingAnalysis analysis = { .elementId = parent->id, .xAxis = xAxis };
+            if (context->sizingAnalysisFunction) {
+                context->sizingAnalysisFunction(analysis, context->sizingAnalysisUserData);
+            }
             Clay_LayoutConfig *parentStyleConfig = parent->layoutConfig;
             int32_t growContainerCount = 0;
             float parentSize = xAxis ? parent->dimensions.width : parent->dimensions.height;
@@ -2148,6 +2306,11 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
                 }
             }
 
+            analysis.finished = true;
+            analysis.alongLayoutAxis = sizingAlongAxis;
+            analysis.childCount = parent->childrenOrTextContent.children.length;
+            analysis.growChildCount = growContainerCount;
+            analysis.resizableChildCount = resizableContainerBuffer.length;
             if (sizingAlongAxis) {
                 float sizeToDistribute = parentSize - parentPadding - innerContentSize;
                 // The content is too large, compress the children as much as possible
@@ -2156,11 +2319,16 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
                     Clay_ScrollElementConfig *scrollElementConfig = Clay__FindElementConfigWithType(parent, CLAY__ELEMENT_CONFIG_TYPE_SCROLL).scrollElementConfig;
                     if (scrollElementConfig) {
                         if (((xAxis && scrollElementConfig->horizontal) || (!xAxis && scrollElementConfig->vertical))) {
+                            if (context->sizingAnalysisFunction) {
+                                context->sizingAnalysisFunction(analysis, context->sizingAnalysisUserData);
+                            }
                             continue;
                         }
                     }
+                    analysis.compressedOverflow = resizableContainerBuffer.length > 0;
                     // Scrolling containers preferentially compress before others
                     while (sizeToDistribute < -CLAY__EPSILON && resizableContainerBuffer.length > 0) {
+                        analysis.iterations++;
                         float largest = 0;
                         float secondLargest = 0;
                         float widthToAdd = sizeToDistribute;
@@ -2204,7 +2372,9 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
                             Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
                         }
                     }
+                    analysis.resizableChildCount = resizableContainerBuffer.length;
                     while (sizeToDistribute > CLAY__EPSILON && resizableContainerBuffer.length > 0) {
+                        analysis.iterations++;
                         float smallest = CLAY__MAXFLOAT;
                         float secondSmallest = CLAY__MAXFLOAT;
                         float widthToAdd = sizeToDistribute;
@@ -2266,6 +2436,9 @@ void Clay__SizeContainersAlongAxis(bool xAxis) {
                     *childSize = CLAY__MAX(minSize, CLAY__MIN(*childSize, maxSize));
                 }
             }
+            if (context->sizingAnalysisFunction) {
+                context->sizingAnalysisFunction(analysis, context->sizingAnalysisUserData);
+            }
         }
     }
 }
@@ -2328,65 +2501,165 @@ bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
            (boundingBox->y + boundingBox->height < 0);
 }
 
+// The part of the screen an element can appear in: the layout dimensions intersected with the bounding box of its nearest scroll container.
+// Only valid during Clay__CalculateFinalLayout, after the clip element itself has been positioned.
+Clay_BoundingBox Clay__GetVisibleBounds(uint32_t clipElementId) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_BoundingBox screen = { 0, 0, context->layoutDimensions.width, context->layoutDimensions.height };
+    // Externally scrolled content is offset by the renderer, so its position here says nothing about what is inside the clip rectangle
+    if (clipElementId == 0 || context->externalScrollHandlingEnabled) {
+        return screen;
+    }
+    if (clipElementId != context->cullingClipElementId) {
+        Clay_LayoutElementHashMapItem *clipItem = Clay__GetHashMapItem(clipElementId);
+        Clay_BoundingBox clipBox = clipItem->boundingBox;
+        float left = CLAY__MAX(screen.x, clipBox.x);
+        float top = CLAY__MAX(screen.y, clipBox.y);
+        float right = CLAY__MIN(screen.x + screen.width, clipBox.x + clipBox.width);
+        float bottom = CLAY__MIN(screen.y + screen.height, clipBox.y + clipBox.height);
+        context->cullingVisibleBounds = CLAY__INIT(Clay_BoundingBox) { left, top, CLAY__MAX(right - left, 0), CLAY__MAX(bottom - top, 0) };
+        context->cullingClipElementId = clipElementId;
+    }
+    return context->cullingVisibleBounds;
+}
+
+// Like Clay__ElementIsOffscreen, but also true for elements scrolled entirely outside their scroll container
+bool Clay__ElementIsClipped(Clay_BoundingBox *boundingBox, uint32_t clipElementId) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context->disableCulling) {
+        return false;
+    }
+    Clay_BoundingBox visibleBounds = Clay__GetVisibleBounds(clipElementId);
+    return (boundingBox->x > visibleBounds.x + visibleBounds.width) ||
+           (boundingBox->y > visibleBounds.y + visibleBounds.height) ||
+           (boundingBox->x + boundingBox->width < visibleBounds.x) ||
+           (boundingBox->y + boundingBox->height < visibleBounds.y);
+}
+
+void Clay__StoreWrappedTextResult(Clay_LayoutElement *containerElement, Clay__MeasureTextCacheItem *measureTextCacheItem) {
+    Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(containerElement->id);
+    if (hashMapItem != &Clay_LayoutElementHashMapItem_DEFAULT) {
+        hashMapItem->wrappedTextId = measureTextCacheItem->id;
+        hashMapItem->wrappedTextWidth = containerElement->dimensions.width;
+        hashMapItem->wrappedTextHeight = containerElement->dimensions.height;
+    }
+}
+
+void Clay__WrapTextElement(Clay__TextElementData *textElementData, Clay_LayoutElement *containerElement, Clay_TextElementConfig *textConfig, Clay__MeasureTextCacheItem *measureTextCacheItem) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    textElementData->wrapDeferred = false;
+    textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) { .length = 0, .internalArray = &context->wrappedTextLines.internalArray[context->wrappedTextLines.length] };
+    float lineWidth = 0;
+    float lineHeight = textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : textElementData->preferredDimensions.height;
+    int32_t lineLengthChars = 0;
+    int32_t lineStartOffset = 0;
+    if (!measureTextCacheItem->containsNewlines && textElementData->preferredDimensions.width <= containerElement->dimensions.width) {
+        Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { containerElement->dimensions,  textElementData->text });
+        textElementData->wrappedLines.length++;
+        Clay__StoreWrappedTextResult(containerElement, measureTextCacheItem);
+        return;
+    }
+    float spaceWidth = Clay__MeasureTextCounted(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, textConfig).width;
+    int32_t wordIndex = measureTextCacheItem->measuredWordsStartIndex;
+    while (wordIndex != -1) {
+        if (context->wrappedTextLines.length > context->wrappedTextLines.capacity - 1) {
+            break;
+        }
+        Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
+        // Only word on the line is too large, just render it anyway
+        if (lineLengthChars == 0 && lineWidth + measuredWord->width > containerElement->dimensions.width) {
+            Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { measuredWord->width, lineHeight }, { .length = measuredWord->length, .chars = &textElementData->text.chars[measuredWord->startOffset] } });
+            textElementData->wrappedLines.length++;
+            wordIndex = measuredWord->next;
+            lineStartOffset = measuredWord->startOffset + measuredWord->length;
+        }
+        // measuredWord->length == 0 means a newline character
+        else if (measuredWord->length == 0 || lineWidth + measuredWord->width > containerElement->dimensions.width) {
+            // Wrapped text lines list has overflowed, just render out the line
+            bool finalCharIsSpace = textElementData->text.chars[lineStartOffset + lineLengthChars - 1] == ' ';
+            Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth + (finalCharIsSpace ? -spaceWidth : 0), lineHeight }, { .length = lineLengthChars + (finalCharIsSpace ? -1 : 0), .chars = &textElementData->text.chars[lineStartOffset] } });
+            textElementData->wrappedLines.length++;
+            if (lineLengthChars == 0 || measuredWord->length == 0) {
+                wordIndex = measuredWord->next;
+            }
+            lineWidth = 0;
+            lineLengthChars = 0;
+            lineStartOffset = measuredWord->startOffset;
+        } else {
+            lineWidth += measuredWord->width;
+            lineLengthChars += measuredWord->length;
+            wordIndex = measuredWord->next;
+        }
+    }
+    if (lineLengthChars > 0) {
+        Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth, lineHeight }, {.length = lineLengthChars, .chars = &textElementData->text.chars[lineStartOffset] } });
+        textElementData->wrappedLines.length++;
+    }
+    containerElement->dimensions.height = lineHeight * (float)textElementData->wrappedLines.length;
+    Clay__StoreWrappedTextResult(containerElement, measureTextCacheItem);
+}
+
+// Stable LSD radix sort of tree roots by zIndex, two passes of 8 bits. Roots with equal zIndex keep their declaration order.
+void Clay__SortLayoutElementTreeRoots(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__LayoutElementTreeRootArray *source = &context->layoutElementTreeRoots;
+    Clay__LayoutElementTreeRootArray *destination = &context->layoutElementTreeRootsSortBuffer;
+    int32_t length = source->length;
+    for (int32_t pass = 0; pass < 2; ++pass) {
+        int32_t shift = pass * 8;
+        int32_t bucketOffsets[256] = CLAY__DEFAULT_STRUCT;
+        for (int32_t i = 0; i < length; ++i) {
+            // Flip the sign bit so negative zIndex values order before positive ones
+            uint16_t key = (uint16_t)source->internalArray[i].zIndex ^ 0x8000;
+            bucketOffsets[(key >> shift) & 0xFF]++;
+        }
+        int32_t total = 0;
+        for (int32_t bucket = 0; bucket < 256; ++bucket) {
+            int32_t count = bucketOffsets[bucket];
+            bucketOffsets[bucket] = total;
+            total += count;
+        }
+        for (int32_t i = 0; i < length; ++i) {
+            uint16_t key = (uint16_t)source->internalArray[i].zIndex ^ 0x8000;
+            destination->internalArray[bucketOffsets[(key >> shift) & 0xFF]++] = source->internalArray[i];
+        }
+        destination->length = length;
+        Clay__LayoutElementTreeRootArray *swap = source;
+        source = destination;
+        destination = swap;
+    }
+    // After an even number of passes the sorted roots are back in layoutElementTreeRoots
+    context->layoutElementTreeRootsNeedSort = false;
+}
+
 void Clay__CalculateFinalLayout(void) {
     Clay_Context* context = Clay_GetCurrentContext();
     // Calculate sizing along the X axis
+    CLAY__TRACE_BEGIN("Clay__SizeContainersAlongAxis x");
     Clay__SizeContainersAlongAxis(true);
+    CLAY__TRACE_END("Clay__SizeContainersAlongAxis x");
 
     // Wrap text
+    CLAY__TRACE_BEGIN("Clay wrap text");
     for (int32_t textElementIndex = 0; textElementIndex < context->textElementData.length; ++textElementIndex) {
         Clay__TextElementData *textElementData = Clay__TextElementDataArray_Get(&context->textElementData, textElementIndex);
-        textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) { .length = 0, .internalArray = &context->wrappedTextLines.internalArray[context->wrappedTextLines.length] };
         Clay_LayoutElement *containerElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)textElementData->elementIndex);
         Clay_TextElementConfig *textConfig = Clay__FindElementConfigWithType(containerElement, CLAY__ELEMENT_CONFIG_TYPE_TEXT).textElementConfig;
         Clay__MeasureTextCacheItem *measureTextCacheItem = Clay__MeasureTextCached(&textElementData->text, textConfig);
-        float lineWidth = 0;
-        float lineHeight = textConfig->lineHeight > 0 ? (float)textConfig->lineHeight : textElementData->preferredDimensions.height;
-        int32_t lineLengthChars = 0;
-        int32_t lineStartOffset = 0;
-        if (!measureTextCacheItem->containsNewlines && textElementData->preferredDimensions.width <= containerElement->dimensions.width) {
-            Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { containerElement->dimensions,  textElementData->text });
-            textElementData->wrappedLines.length++;
+        // Text that was entirely clipped last frame with the same contents and width wraps to the same height, so wrapping can wait until
+        // the final pass finds out whether it is visible this frame
+        Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(containerElement->id);
+        if (!context->disableCulling && hashMapItem != &Clay_LayoutElementHashMapItem_DEFAULT && hashMapItem->wrappedTextClipped
+                && hashMapItem->wrappedTextId == measureTextCacheItem->id && hashMapItem->wrappedTextWidth == containerElement->dimensions.width) {
+            textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) CLAY__DEFAULT_STRUCT;
+            textElementData->wrapDeferred = true;
+            textElementData->measureTextCacheItem = measureTextCacheItem;
+            containerElement->dimensions.height = hashMapItem->wrappedTextHeight;
             continue;
         }
-        float spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, textConfig, context->measureTextUserData).width;
-        int32_t wordIndex = measureTextCacheItem->measuredWordsStartIndex;
-        while (wordIndex != -1) {
-            if (context->wrappedTextLines.length > context->wrappedTextLines.capacity - 1) {
-                break;
-            }
-            Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
-            // Only word on the line is too large, just render it anyway
-            if (lineLengthChars == 0 && lineWidth + measuredWord->width > containerElement->dimensions.width) {
-                Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { measuredWord->width, lineHeight }, { .length = measuredWord->length, .chars = &textElementData->text.chars[measuredWord->startOffset] } });
-                textElementData->wrappedLines.length++;
-                wordIndex = measuredWord->next;
-                lineStartOffset = measuredWord->startOffset + measuredWord->length;
-            }
-            // measuredWord->length == 0 means a newline character
-            else if (measuredWord->length == 0 || lineWidth + measuredWord->width > containerElement->dimensions.width) {
-                // Wrapped text lines list has overflowed, just render out the line
-                bool finalCharIsSpace = textElementData->text.chars[lineStartOffset + lineLengthChars - 1] == ' ';
-                Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth + (finalCharIsSpace ? -spaceWidth : 0), lineHeight }, { .length = lineLengthChars + (finalCharIsSpace ? -1 : 0), .chars = &textElementData->text.chars[lineStartOffset] } });
-                textElementData->wrappedLines.length++;
-                if (lineLengthChars == 0 || measuredWord->length == 0) {
-                    wordIndex = measuredWord->next;
-                }
-                lineWidth = 0;
-                lineLengthChars = 0;
-                lineStartOffset = measuredWord->startOffset;
-            } else {
-                lineWidth += measuredWord->width;
-                lineLengthChars += measuredWord->length;
-                wordIndex = measuredWord->next;
-            }
-        }
-        if (lineLengthChars > 0) {
-            Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { { lineWidth, lineHeight }, {.length = lineLengthChars, .chars = &textElementData->text.chars[lineStartOffset] } });
-            textElementData->wrappedLines.length++;
-        }
-        containerElement->dimensions.height = lineHeight * (float)textElementData->wrappedLines.length;
+        Clay__WrapTextElement(textElementData, containerElement, textConfig, measureTextCacheItem);
     }
+    CLAY__TRACE_END("Clay wrap text");
 
     // Scale vertical image heights according to aspect ratio
     for (int32_t i = 0; i < context->imageElementPointers.length; ++i) {
@@ -2444,24 +2717,22 @@ void Clay__CalculateFinalLayout(void) {
     }
 
     // Calculate sizing along the Y axis
+    CLAY__TRACE_BEGIN("Clay__SizeContainersAlongAxis y");
     Clay__SizeContainersAlongAxis(false);
+    CLAY__TRACE_END("Clay__SizeContainersAlongAxis y");
 
     // Sort tree roots by z-index
-    int32_t sortMax = context->layoutElementTreeRoots.length - 1;
-    while (sortMax > 0) { // todo dumb bubble sort
-        for (int32_t i = 0; i < sortMax; ++i) {
-            Clay__LayoutElementTreeRoot current = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
-            Clay__LayoutElementTreeRoot next = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i + 1);
-            if (next.zIndex < current.zIndex) {
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i, next);
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i + 1, current);
-            }
-        }
-        sortMax--;
+    if (context->layoutElementTreeRootsNeedSort) {
+        CLAY__TRACE_BEGIN("Clay z-sort");
+        Clay__SortLayoutElementTreeRoots();
+        CLAY__TRACE_END("Clay z-sort");
     }
+    int32_t sortMax;
 
     // Calculate final positions and generate render commands
+    CLAY__TRACE_BEGIN("Clay render commands");
     context->renderCommands.length = 0;
+    context->cullingClipElementId = 0;
     dfsBuffer.length = 0;
     for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
         dfsBuffer.length = 0;
@@ -2530,17 +2801,14 @@ void Clay__CalculateFinalLayout(void) {
                 // Floating elements that are attached to scrolling contents won't be correctly positioned if external scroll handling is enabled, fix here
                 if (context->externalScrollHandlingEnabled) {
                     Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(clipHashMapItem->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL).scrollElementConfig;
-                    for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
-                        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-                        if (mapping->layoutElement == clipHashMapItem->layoutElement) {
-                            root->pointerOffset = mapping->scrollPosition;
-                            if (scrollConfig->horizontal) {
-                                rootPosition.x += mapping->scrollPosition.x;
-                            }
-                            if (scrollConfig->vertical) {
-                                rootPosition.y += mapping->scrollPosition.y;
-                            }
-                            break;
+                    Clay__ScrollContainerDataInternal *mapping = Clay__GetScrollContainerData(clipHashMapItem->layoutElement->id);
+                    if (mapping && mapping->layoutElement == clipHashMapItem->layoutElement) {
+                        root->pointerOffset = mapping->scrollPosition;
+                        if (scrollConfig->horizontal) {
+                            rootPosition.x += mapping->scrollPosition.x;
+                        }
+                        if (scrollConfig->vertical) {
+                            rootPosition.y += mapping->scrollPosition.y;
                         }
                     }
                 }
@@ -2581,22 +2849,22 @@ void Clay__CalculateFinalLayout(void) {
                 if (Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL)) {
                     Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL).scrollElementConfig;
 
-                    // This linear scan could theoretically be slow under very strange conditions, but I can't imagine a real UI with more than a few 10's of scroll containers
-                    for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
-                        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-                        if (mapping->layoutElement == currentElement) {
-                            scrollContainerData = mapping;
-                            mapping->boundingBox = currentElementBoundingBox;
-                            if (scrollConfig->horizontal) {
-                                scrollOffset.x = mapping->scrollPosition.x;
-                            }
-                            if (scrollConfig->vertical) {
-                                scrollOffset.y = mapping->scrollPosition.y;
-                            }
-                            if (context->externalScrollHandlingEnabled) {
-                                scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
-                            }
-                            break;
+                    // This element's bounding box is about to change, so drop any visible bounds cached for it
+                    if (context->cullingClipElementId == currentElement->id) {
+                        context->cullingClipElementId = 0;
+                    }
+                    Clay__ScrollContainerDataInternal *mapping = Clay__GetScrollContainerData(currentElement->id);
+                    if (mapping && mapping->layoutElement == currentElement) {
+                        scrollContainerData = mapping;
+                        mapping->boundingBox = currentElementBoundingBox;
+                        if (scrollConfig->horizontal) {
+                            scrollOffset.x = mapping->scrollPosition.x;
+                        }
+                        if (scrollConfig->vertical) {
+                            scrollOffset.y = mapping->scrollPosition.y;
+                        }
+                        if (context->externalScrollHandlingEnabled) {
+                            scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
                         }
                     }
                 }
@@ -2631,6 +2899,8 @@ void Clay__CalculateFinalLayout(void) {
                     sortMax--;
                 }
 
+                uint32_t clipElementId = (uint32_t)Clay__int32_tArray_GetValue(&context->layoutElementClipElementIds, (int32_t)(currentElement - context->layoutElements.internalArray));
+                bool offscreen = Clay__ElementIsClipped(&currentElementBoundingBox, clipElementId);
                 bool emitRectangle = false;
                 // Create the render commands for this element
                 Clay_SharedElementConfig *sharedConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED).sharedElementConfig;
@@ -2649,8 +2919,7 @@ void Clay__CalculateFinalLayout(void) {
                         .id = currentElement->id,
                     };
 
-                    bool offscreen = Clay__ElementIsOffscreen(&currentElementBoundingBox);
-                    // Culling - Don't bother to generate render commands for rectangles entirely outside the screen - this won't stop their children from being rendered if they overflow
+                    // Culling - Don't bother to generate render commands for rectangles entirely outside the screen or their scroll container - this won't stop their children from being rendered if they overflow
                     bool shouldRender = !offscreen;
                     switch (elementConfig->type) {
                         case CLAY__ELEMENT_CONFIG_TYPE_FLOATING:
@@ -2660,6 +2929,8 @@ void Clay__CalculateFinalLayout(void) {
                             break;
                         }
                         case CLAY__ELEMENT_CONFIG_TYPE_SCROLL: {
+                            // Never culled, its SCISSOR_END is always emitted and renderers treat that as "clipping off", which would unclip the following siblings inside an outer scroll container
+                            shouldRender = true;
                             renderCommand.commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_START;
                             renderCommand.renderData = CLAY__INIT(Clay_RenderData) {
                                 .scroll = {
@@ -2683,19 +2954,30 @@ void Clay__CalculateFinalLayout(void) {
                             break;
                         }
                         case CLAY__ELEMENT_CONFIG_TYPE_TEXT: {
+                            if (hashMapItem != &Clay_LayoutElementHashMapItem_DEFAULT) {
+                                hashMapItem->wrappedTextClipped = offscreen;
+                            }
                             if (!shouldRender) {
                                 break;
                             }
                             shouldRender = false;
                             Clay_ElementConfigUnion configUnion = elementConfig->config;
                             Clay_TextElementConfig *textElementConfig = configUnion.textElementConfig;
-                            float naturalLineHeight = currentElement->childrenOrTextContent.textElementData->preferredDimensions.height;
+                            Clay__TextElementData *textElementData = currentElement->childrenOrTextContent.textElementData;
+                            if (textElementData->wrapDeferred) {
+                                // Scrolled back into view, the height is already known so only the lines need to be produced
+                                Clay__WrapTextElement(textElementData, currentElement, textElementConfig, textElementData->measureTextCacheItem);
+                            }
+                            Clay_BoundingBox visibleBounds = Clay__GetVisibleBounds(clipElementId);
+                            float naturalLineHeight = textElementData->preferredDimensions.height;
                             float finalLineHeight = textElementConfig->lineHeight > 0 ? (float)textElementConfig->lineHeight : naturalLineHeight;
                             float lineHeightOffset = (finalLineHeight - naturalLineHeight) / 2;
                             float yPosition = lineHeightOffset;
-                            for (int32_t lineIndex = 0; lineIndex < currentElement->childrenOrTextContent.textElementData->wrappedLines.length; ++lineIndex) {
-                                Clay__WrappedTextLine *wrappedLine = Clay__WrappedTextLineArraySlice_Get(&currentElement->childrenOrTextContent.textElementData->wrappedLines, lineIndex);
-                                if (wrappedLine->line.length == 0) {
+                            for (int32_t lineIndex = 0; lineIndex < textElementData->wrappedLines.length; ++lineIndex) {
+                                Clay__WrappedTextLine *wrappedLine = Clay__WrappedTextLineArraySlice_Get(&textElementData->wrappedLines, lineIndex);
+                                // Skip lines above the visible area, e.g. the start of a long paragraph scrolled past the top of its container
+                                bool lineAboveVisibleBounds = !context->disableCulling && currentElementBoundingBox.y + yPosition + finalLineHeight < visibleBounds.y;
+                                if (wrappedLine->line.length == 0 || lineAboveVisibleBounds) {
                                     yPosition += finalLineHeight;
                                     continue;
                                 }
@@ -2709,7 +2991,7 @@ void Clay__CalculateFinalLayout(void) {
                                 Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
                                     .boundingBox = { currentElementBoundingBox.x + offset, currentElementBoundingBox.y + yPosition, wrappedLine->dimensions.width, wrappedLine->dimensions.height },
                                     .renderData = { .text = {
-                                        .stringContents = CLAY__INIT(Clay_StringSlice) { .length = wrappedLine->line.length, .chars = wrappedLine->line.chars, .baseChars = currentElement->childrenOrTextContent.textElementData->text.chars },
+                                        .stringContents = CLAY__INIT(Clay_StringSlice) { .length = wrappedLine->line.length, .chars = wrappedLine->line.chars, .baseChars = textElementData->text.chars },
                                         .textColor = textElementConfig->textColor,
                                         .fontId = textElementConfig->fontId,
                                         .fontSize = textElementConfig->fontSize,
@@ -2723,7 +3005,7 @@ void Clay__CalculateFinalLayout(void) {
                                 });
                                 yPosition += finalLineHeight;
 
-                                if (!context->disableCulling && (currentElementBoundingBox.y + yPosition > context->layoutDimensions.height)) {
+                                if (!context->disableCulling && (currentElementBoundingBox.y + yPosition > visibleBounds.y + visibleBounds.height)) {
                                     break;
                                 }
                             }
@@ -2811,15 +3093,12 @@ void Clay__CalculateFinalLayout(void) {
                 Clay_ScrollElementConfig *scrollConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL).scrollElementConfig;
                 if (scrollConfig) {
                     closeScrollElement = true;
-                    for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
-                        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-                        if (mapping->layoutElement == currentElement) {
-                            if (scrollConfig->horizontal) { scrollOffset.x = mapping->scrollPosition.x; }
-                            if (scrollConfig->vertical) { scrollOffset.y = mapping->scrollPosition.y; }
-                            if (context->externalScrollHandlingEnabled) {
-                                scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
-                            }
-                            break;
+                    Clay__ScrollContainerDataInternal *mapping = Clay__GetScrollContainerData(currentElement->id);
+                    if (mapping && mapping->layoutElement == currentElement) {
+                        if (scrollConfig->horizontal) { scrollOffset.x = mapping->scrollPosition.x; }
+                        if (scrollConfig->vertical) { scrollOffset.y = mapping->scrollPosition.y; }
+                        if (context->externalScrollHandlingEnabled) {
+                            scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
                         }
                     }
                 }
@@ -2829,7 +3108,8 @@ void Clay__CalculateFinalLayout(void) {
                     Clay_BoundingBox currentElementBoundingBox = currentElementData->boundingBox;
 
                     // Culling - Don't bother to generate render commands for rectangles entirely outside the screen - this won't stop their children from being rendered if they overflow
-                    if (!Clay__ElementIsOffscreen(&currentElementBoundingBox)) {
+                    uint32_t clipElementId = (uint32_t)Clay__int32_tArray_GetValue(&context->layoutElementClipElementIds, (int32_t)(currentElement - context->layoutElements.internalArray));
+                    if (!Clay__ElementIsClipped(&currentElementBoundingBox, clipElementId)) {
                         Clay_SharedElementConfig *sharedConfig = Clay__ElementHasConfig(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED) ? Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_SHARED).sharedElementConfig : &Clay_SharedElementConfig_DEFAULT;
                         Clay_BorderElementConfig *borderConfig = Clay__FindElementConfigWithType(currentElement, CLAY__ELEMENT_CONFIG_TYPE_BORDER).borderElementConfig;
                         Clay_RenderCommand renderCommand = {
@@ -2947,6 +3227,7 @@ void Clay__CalculateFinalLayout(void) {
             Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) { .id = Clay__HashNumber(rootElement->id, rootElement->childrenOrTextContent.children.length + 11).id, .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END });
         }
     }
+    CLAY__TRACE_END("Clay render commands");
 }
 
 #pragma region DebugTools
@@ -3241,15 +3522,12 @@ void Clay__RenderDebugView(void) {
     Clay_ElementId scrollId = Clay__HashString(CLAY_STRING("Clay__DebugViewOuterScrollPane"), 0, 0);
     float scrollYOffset = 0;
     bool pointerInDebugView = context->pointerInfo.position.y < context->layoutDimensions.height - 300;
-    for (int32_t i = 0; i < context->scrollContainerDatas.length; ++i) {
-        Clay__ScrollContainerDataInternal *scrollContainerData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-        if (scrollContainerData->elementId == scrollId.id) {
-            if (!context->externalScrollHandlingEnabled) {
-                scrollYOffset = scrollContainerData->scrollPosition.y;
-            } else {
-                pointerInDebugView = context->pointerInfo.position.y + scrollContainerData->scrollPosition.y < context->layoutDimensions.height - 300;
-            }
-            break;
+    Clay__ScrollContainerDataInternal *scrollContainerData = Clay__GetScrollContainerData(scrollId.id);
+    if (scrollContainerData) {
+        if (!context->externalScrollHandlingEnabled) {
+            scrollYOffset = scrollContainerData->scrollPosition.y;
+        } else {
+            pointerInDebugView = context->pointerInfo.position.y + scrollContainerData->scrollPosition.y < context->layoutDimensions.height - 300;
         }
     }
     int32_t highlightedRow = pointerInDebugView
@@ -3637,6 +3915,7 @@ uint32_t Clay_MinMemorySize(void) {
     Clay_Context fakeContext = {
         .maxElementCount = Clay__defaultMaxElementCount,
         .maxMeasureTextCacheWordCount = Clay__defaultMaxMeasureTextWordCacheCount,
+        .maxScrollContainerCount = Clay__defaultMaxScrollContainerCount,
         .internalArena = {
             .capacity = SIZE_MAX,
             .memory = NULL,
@@ -3646,6 +3925,7 @@ uint32_t Clay_MinMemorySize(void) {
     if (currentContext) {
         fakeContext.maxElementCount = currentContext->maxElementCount;
         fakeContext.maxMeasureTextCacheWordCount = currentContext->maxMeasureTextCacheWordCount;
+        fakeContext.maxScrollContainerCount = currentContext->maxScrollContainerCount;
     }
     // Reserve space in the arena for the context, important for calculating min memory size correctly
     Clay__Context_Allocate_Arena(&fakeContext.internalArena);
@@ -3687,6 +3967,7 @@ void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
     if (context->booleanWarnings.maxElementsExceeded) {
         return;
     }
+    CLAY__TRACE_BEGIN("Clay_SetPointerState");
     context->pointerInfo.position = position;
     context->pointerOverIds.length = 0;
     Clay__int32_tArray dfsBuffer = context->layoutElementChildrenBuffer;
@@ -3754,6 +4035,7 @@ void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
             context->pointerInfo.state = CLAY_POINTER_DATA_RELEASED_THIS_FRAME;
         }
     }
+    CLAY__TRACE_END("Clay_SetPointerState");
 }
 
 CLAY_WASM_EXPORT("Clay_Initialize")
@@ -3765,6 +4047,7 @@ Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions
     *context = CLAY__INIT(Clay_Context) {
         .maxElementCount = oldContext ? oldContext->maxElementCount : Clay__defaultMaxElementCount,
         .maxMeasureTextCacheWordCount = oldContext ? oldContext->maxMeasureTextCacheWordCount : Clay__defaultMaxMeasureTextWordCacheCount,
+        .maxScrollContainerCount = oldContext ? oldContext->maxScrollContainerCount : Clay__defaultMaxScrollContainerCount,
         .errorHandler = errorHandler.errorHandlerFunction ? errorHandler : CLAY__INIT(Clay_ErrorHandler) { Clay__ErrorHandlerFunctionDefault, 0 },
         .layoutDimensions = layoutDimensions,
         .internalArena = arena,
@@ -3778,6 +4061,9 @@ Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions
     for (int32_t i = 0; i < context->measureTextHashMap.capacity; ++i) {
         context->measureTextHashMap.internalArray[i] = 0;
     }
+    for (int32_t i = 0; i < context->scrollContainerHashMap.capacity; ++i) {
+        context->scrollContainerHashMap.internalArray[i] = -1;
+    }
     context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
     context->layoutDimensions = layoutDimensions;
     return context;
@@ -3796,14 +4082,18 @@ void Clay_SetCurrentContext(Clay_Context* context) {
 CLAY_WASM_EXPORT("Clay_UpdateScrollContainers")
 void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDelta, float deltaTime) {
     Clay_Context* context = Clay_GetCurrentContext();
+    CLAY__TRACE_BEGIN("Clay_UpdateScrollContainers");
     bool isPointerActive = enableDragScrolling && (context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED || context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME);
     // Don't apply scroll events to ancestors of the inner element
     int32_t highestPriorityElementIndex = -1;
     Clay__ScrollContainerDataInternal *highestPriorityScrollData = CLAY__NULL;
+    bool scrollDataRemoved = false;
     for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
         Clay__ScrollContainerDataInternal *scrollData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
         if (!scrollData->openThisFrame) {
             Clay__ScrollContainerDataInternalArray_RemoveSwapback(&context->scrollContainerDatas, i);
+            scrollDataRemoved = true;
+            i--; // Revisit the element that was swapped into this slot
             continue;
         }
         scrollData->openThisFrame = false;
@@ -3811,6 +4101,8 @@ void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDe
         // Element isn't rendered this frame but scroll offset has been retained
         if (!hashMapItem) {
             Clay__ScrollContainerDataInternalArray_RemoveSwapback(&context->scrollContainerDatas, i);
+            scrollDataRemoved = true;
+            i--;
             continue;
         }
 
@@ -3847,11 +4139,17 @@ void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDe
         }
         scrollData->scrollPosition.y = CLAY__MIN(CLAY__MAX(scrollData->scrollPosition.y, -(CLAY__MAX(scrollData->contentSize.height - scrollData->layoutElement->dimensions.height, 0))), 0);
 
-        for (int32_t j = 0; j < context->pointerOverIds.length; ++j) { // TODO n & m are small here but this being n*m gives me the creeps
-            if (scrollData->layoutElement->id == Clay__ElementIdArray_Get(&context->pointerOverIds, j)->id) {
-                highestPriorityElementIndex = j;
-                highestPriorityScrollData = scrollData;
-            }
+    }
+    if (scrollDataRemoved) {
+        Clay__RebuildScrollContainerHashMap();
+    }
+
+    // pointerOverIds is ordered from outermost to innermost, so the last hovered scroll container takes the scroll
+    for (int32_t j = 0; j < context->pointerOverIds.length; ++j) {
+        Clay__ScrollContainerDataInternal *scrollData = Clay__GetScrollContainerData(Clay__ElementIdArray_Get(&context->pointerOverIds, j)->id);
+        if (scrollData) {
+            highestPriorityElementIndex = j;
+            highestPriorityScrollData = scrollData;
         }
     }
 
@@ -3905,6 +4203,7 @@ void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDe
             highestPriorityScrollData->scrollPosition.x = CLAY__MAX(CLAY__MIN(highestPriorityScrollData->scrollPosition.x, 0), -(highestPriorityScrollData->contentSize.width - scrollElement->dimensions.width));
         }
     }
+    CLAY__TRACE_END("Clay_UpdateScrollContainers");
 }
 
 CLAY_WASM_EXPORT("Clay_BeginLayout")
@@ -4011,18 +4310,15 @@ bool Clay_PointerOver(Clay_ElementId elementId) { // TODO return priority for se
 
 CLAY_WASM_EXPORT("Clay_GetScrollContainerData")
 Clay_ScrollContainerData Clay_GetScrollContainerData(Clay_ElementId id) {
-    Clay_Context* context = Clay_GetCurrentContext();
-    for (int32_t i = 0; i < context->scrollContainerDatas.length; ++i) {
-        Clay__ScrollContainerDataInternal *scrollContainerData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-        if (scrollContainerData->elementId == id.id) {
-            return CLAY__INIT(Clay_ScrollContainerData) {
-                .scrollPosition = &scrollContainerData->scrollPosition,
-                .scrollContainerDimensions = { scrollContainerData->boundingBox.width, scrollContainerData->boundingBox.height },
-                .contentDimensions = scrollContainerData->contentSize,
-                .config = *Clay__FindElementConfigWithType(scrollContainerData->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL).scrollElementConfig,
-                .found = true
-            };
-        }
+    Clay__ScrollContainerDataInternal *scrollContainerData = Clay__GetScrollContainerData(id.id);
+    if (scrollContainerData) {
+        return CLAY__INIT(Clay_ScrollContainerData) {
+            .scrollPosition = &scrollContainerData->scrollPosition,
+            .scrollContainerDimensions = { scrollContainerData->boundingBox.width, scrollContainerData->boundingBox.height },
+            .contentDimensions = scrollContainerData->contentSize,
+            .config = *Clay__FindElementConfigWithType(scrollContainerData->layoutElement, CLAY__ELEMENT_CONFIG_TYPE_SCROLL).scrollElementConfig,
+            .found = true
+        };
     }
     return CLAY__INIT(Clay_ScrollContainerData) CLAY__DEFAULT_STRUCT;
 }
@@ -4097,6 +4393,22 @@ void Clay_SetMaxMeasureTextCacheWordCount(int32_t maxMeasureTextCacheWordCount)
     }
 }
 
+CLAY_WASM_EXPORT("Clay_GetMaxScrollContainerCount")
+int32_t Clay_GetMaxScrollContainerCount(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    return context ? context->maxScrollContainerCount : Clay__defaultMaxScrollContainerCount;
+}
+
+CLAY_WASM_EXPORT("Clay_SetMaxScrollContainerCount")
+void Clay_SetMaxScrollContainerCount(int32_t maxScrollContainerCount) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context) {
+        context->maxScrollContainerCount = maxScrollContainerCount;
+    } else {
+        Clay__defaultMaxScrollContainerCount = maxScrollContainerCount;
+    }
+}
+
 CLAY_WASM_EXPORT("Clay_ResetMeasureTextCache")
 void Clay_ResetMeasureTextCache(void) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4112,6 +4424,36 @@ void Clay_ResetMeasureTextCache(void) {
     context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
 }
 
+CLAY_WASM_EXPORT("Clay_SetSizingAnalysisFunction")
+void Clay_SetSizingAnalysisFunction(void (*sizingAnalysisFunction)(Clay_SizingAnalysis analysis, void *userData), void *userData) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->sizingAnalysisFunction = sizingAnalysisFunction;
+    context->sizingAnalysisUserData = userData;
+}
+
+CLAY_WASM_EXPORT("Clay_GetMeasureTextCacheStats")
+Clay_MeasureTextCacheStats Clay_GetMeasureTextCacheStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (!context) {
+        return CLAY__INIT(Clay_MeasureTextCacheStats) CLAY__DEFAULT_STRUCT;
+    }
+    Clay_MeasureTextCacheStats stats = context->measureTextCacheStats;
+    // Index 0 of the item array is reserved, and the last slot of each array is never filled
+    stats.wordsCached = context->measuredWords.length - context->measuredWordsFreeList.length;
+    stats.wordCapacity = context->measuredWords.capacity - 1;
+    stats.entriesCached = context->measureTextHashMapInternal.length - 1 - context->measureTextHashMapInternalFreeList.length;
+    stats.entryCapacity = context->measureTextHashMapInternal.capacity - 2;
+    return stats;
+}
+
+CLAY_WASM_EXPORT("Clay_ResetMeasureTextCacheStats")
+void Clay_ResetMeasureTextCacheStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    if (context) {
+        context->measureTextCacheStats = CLAY__INIT(Clay_MeasureTextCacheStats) CLAY__DEFAULT_STRUCT;
+    }
+}
+
 #endif // CLAY_IMPLEMENTATION
 
 /*
@@ -0,0 +1,85 @@
+// Shelf packer shared by the renderers' image atlases. Small images such as
+// icons are packed into a few large pages so that consecutive IMAGE commands
+// sample the same texture and can be drawn in one batch.
+//
+// Images are placed left to right on horizontal shelves. A new image goes on
+// the shelf whose height wastes the least space, and a new shelf is opened
+// below the last one when none fits.
+
+#ifndef CLAY_ATLAS_HEADER
+#define CLAY_ATLAS_HEADER
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CLAY_ATLAS_MAX_SHELVES
+#define CLAY_ATLAS_MAX_SHELVES 64
+#endif
+
+typedef struct {
+    int32_t x, y, width, height;
+} Clay_AtlasRect;
+
+typedef struct {
+    int32_t y;
+    int32_t height;
+    int32_t cursorX;
+} Clay_AtlasShelf;
+
+typedef struct {
+    int32_t width, height;
+    // Transparent gap left around every image so filtering does not bleed
+    // neighbours into each other
+    int32_t padding;
+    int32_t shelfCount;
+    Clay_AtlasShelf shelves[CLAY_ATLAS_MAX_SHELVES];
+} Clay_AtlasPacker;
+
+static inline void Clay_AtlasPacker_Init(Clay_AtlasPacker *packer, int32_t width, int32_t height, int32_t padding) {
+    packer->width = width;
+    packer->height = height;
+    packer->padding = padding;
+    packer->shelfCount = 0;
+}
+
+// Finds room for a width x height image. Returns false if the page is full,
+// otherwise writes the image's position (excluding padding) to result.
+static inline bool Clay_AtlasPacker_Pack(Clay_AtlasPacker *packer, int32_t width, int32_t height, Clay_AtlasRect *result) {
+    const int32_t paddedWidth = width + packer->padding * 2;
+    const int32_t paddedHeight = height + packer->padding * 2;
+    if (paddedWidth > packer->width || paddedHeight > packer->height) {
+        return false;
+    }
+
+    Clay_AtlasShelf *best = NULL;
+    for (int32_t i = 0; i < packer->shelfCount; i++) {
+        Clay_AtlasShelf *shelf = &packer->shelves[i];
+        if (shelf->height >= paddedHeight && packer->width - shelf->cursorX >= paddedWidth) {
+            if (!best || shelf->height < best->height) {
+                best = shelf;
+            }
+        }
+    }
+
+    if (!best) {
+        const int32_t nextY = packer->shelfCount > 0
+            ? packer->shelves[packer->shelfCount - 1].y + packer->shelves[packer->shelfCount - 1].height
+            : 0;
+        if (packer->shelfCount == CLAY_ATLAS_MAX_SHELVES || nextY + paddedHeight > packer->height) {
+            return false;
+        }
+        best = &packer->shelves[packer->shelfCount++];
+        best->y = nextY;
+        best->height = paddedHeight;
+        best->cursorX = 0;
+    }
+
+    result->x = best->cursorX + packer->padding;
+    result->y = best->y + packer->padding;
+    result->width = width;
+    result->height = height;
+    best->cursorX += paddedWidth;
+    return true;
+}
+
+#endif // CLAY_ATLAS_HEADER
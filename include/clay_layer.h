@@ -0,0 +1,161 @@
+// Cached layers shared by the renderers. An element whose userData points to a
+// Clay_LayerConfig that was registered with a backend has its subtree drawn
+// into an offscreen texture once, and that texture is drawn again on later
+// frames while the subtree's commands stay the same.
+//
+// The subtree is found from the render commands alone: it is the run of
+// commands starting at the first one tagged with the layer, as long as every
+// command is tagged with it (ClayMan::layerElement tags the descendants) or is
+// a SCISSOR_END closing a scissor opened inside the run. The fingerprint hashes
+// the commands relative to the layer's origin, so a layer that only moves is
+// not redrawn.
+
+#ifndef CLAY_LAYER_HEADER
+#define CLAY_LAYER_HEADER
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <math.h>
+
+#include "clay.h"
+
+// Layers larger than this on either side are drawn directly
+#ifndef CLAY_LAYER_MAX_SIZE
+#define CLAY_LAYER_MAX_SIZE 4096
+#endif
+
+typedef struct {
+    // Set to false to draw the subtree directly, e.g. while it animates
+    bool cacheAsLayer;
+    // Left for the application, since the layer takes the element's userData
+    void *userData;
+} Clay_LayerConfig;
+
+typedef struct {
+    // One past the last command of the layer
+    int32_t end;
+    // Whole-pixel origin and size of the union of the drawn commands
+    float x, y;
+    int32_t width, height;
+    uint64_t fingerprint;
+} Clay_LayerExtent;
+
+static inline uint64_t Clay_Layer_HashBytes(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+static inline uint64_t Clay_Layer_HashFloat(uint64_t hash, float value) {
+    return Clay_Layer_HashBytes(hash, &value, sizeof(value));
+}
+
+static inline uint64_t Clay_Layer_HashColor(uint64_t hash, Clay_Color color) {
+    return Clay_Layer_HashBytes(hash, &color, sizeof(color));
+}
+
+static inline uint64_t Clay_Layer_HashCornerRadius(uint64_t hash, Clay_CornerRadius radius) {
+    return Clay_Layer_HashBytes(hash, &radius, sizeof(radius));
+}
+
+// Finds the commands of the layer whose first command is commands[start] and
+// fingerprints them. Pointers are hashed as they are, so edit the pixels behind
+// an IMAGE or CUSTOM command under a new pointer, or toggle cacheAsLayer.
+static inline Clay_LayerExtent Clay_Layer_Measure(const Clay_RenderCommandArray *commands, int32_t start) {
+    Clay_LayerExtent extent = { start + 1, 0, 0, 0, 0, 0 };
+    const void *tag = commands->internalArray[start].userData;
+    int32_t scissorDepth = 0;
+    for (int32_t i = start; i < commands->length; i++) {
+        const Clay_RenderCommand *command = &commands->internalArray[i];
+        const bool tagged = command->userData == tag;
+        if (tagged && command->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START) {
+            scissorDepth++;
+        } else if (command->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END) {
+            if (scissorDepth == 0) break;
+            scissorDepth--;
+        } else if (!tagged) {
+            break;
+        }
+        // Never end inside a scissor, the rest would be drawn unclipped
+        if (scissorDepth == 0) {
+            extent.end = i + 1;
+        }
+    }
+
+    float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+    for (int32_t i = start; i < extent.end; i++) {
+        const Clay_RenderCommand *command = &commands->internalArray[i];
+        if (command->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START || command->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END) {
+            continue;
+        }
+        const Clay_BoundingBox box = command->boundingBox;
+        minX = fminf(minX, box.x);
+        minY = fminf(minY, box.y);
+        maxX = fmaxf(maxX, box.x + box.width);
+        maxY = fmaxf(maxY, box.y + box.height);
+    }
+    // Nothing is drawn, width and height stay 0
+    if (minX > maxX || minY > maxY) {
+        return extent;
+    }
+
+    extent.x = floorf(minX);
+    extent.y = floorf(minY);
+    extent.width = (int32_t)ceilf(maxX - extent.x);
+    extent.height = (int32_t)ceilf(maxY - extent.y);
+
+    uint64_t hash = 14695981039346656037ull;
+    for (int32_t i = start; i < extent.end; i++) {
+        const Clay_RenderCommand *command = &commands->internalArray[i];
+        const Clay_RenderData *data = &command->renderData;
+        hash = Clay_Layer_HashBytes(hash, &command->commandType, sizeof(command->commandType));
+        hash = Clay_Layer_HashFloat(hash, command->boundingBox.x - extent.x);
+        hash = Clay_Layer_HashFloat(hash, command->boundingBox.y - extent.y);
+        hash = Clay_Layer_HashFloat(hash, command->boundingBox.width);
+        hash = Clay_Layer_HashFloat(hash, command->boundingBox.height);
+        switch (command->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+                hash = Clay_Layer_HashColor(hash, data->rectangle.backgroundColor);
+                hash = Clay_Layer_HashCornerRadius(hash, data->rectangle.cornerRadius);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+                const Clay_BorderWidth width = data->border.width;
+                const uint16_t widths[5] = { width.left, width.right, width.top, width.bottom, width.betweenChildren };
+                hash = Clay_Layer_HashColor(hash, data->border.color);
+                hash = Clay_Layer_HashCornerRadius(hash, data->border.cornerRadius);
+                hash = Clay_Layer_HashBytes(hash, widths, sizeof(widths));
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                const Clay_TextRenderData *text = &data->text;
+                const uint16_t metrics[4] = { text->fontId, text->fontSize, text->letterSpacing, text->lineHeight };
+                hash = Clay_Layer_HashBytes(hash, &text->stringContents.length, sizeof(text->stringContents.length));
+                hash = Clay_Layer_HashBytes(hash, text->stringContents.chars, (size_t)text->stringContents.length);
+                hash = Clay_Layer_HashColor(hash, text->textColor);
+                hash = Clay_Layer_HashBytes(hash, metrics, sizeof(metrics));
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+                hash = Clay_Layer_HashColor(hash, data->image.backgroundColor);
+                hash = Clay_Layer_HashCornerRadius(hash, data->image.cornerRadius);
+                hash = Clay_Layer_HashBytes(hash, &data->image.imageData, sizeof(data->image.imageData));
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+                hash = Clay_Layer_HashColor(hash, data->custom.backgroundColor);
+                hash = Clay_Layer_HashCornerRadius(hash, data->custom.cornerRadius);
+                hash = Clay_Layer_HashBytes(hash, &data->custom.customData, sizeof(data->custom.customData));
+                break;
+            }
+            default: break;
+        }
+    }
+    extent.fingerprint = hash;
+    return extent;
+}
+
+#endif // CLAY_LAYER_HEADER
@@ -5,8 +5,11 @@
 #endif
 
 #include "../clay.h"
+#include "../clay_atlas.h"
+#include "../clay_layer.h"
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
 #include "string.h"
 #include "stdio.h"
 #include "stdlib.h"
@@ -131,135 +134,490 @@ void Clay_Raylib_Initialize(int width, int height, const char *title, unsigned i
 //    EnableEventWaiting();
 }
 
-// A MALLOC'd buffer, that we keep modifying inorder to save from so many Malloc and Free Calls.
-// Call Clay_Raylib_Close() to free
-static char *temp_render_buffer = NULL;
-static int temp_render_buffer_len = 0;
+// Small textures registered with Clay_Raylib_AtlasRegister are copied into shared atlas pages,
+// so runs of icons sample one texture and rlgl draws them in one batch.
+#ifndef CLAY_RAYLIB_ATLAS_PAGE_SIZE
+#define CLAY_RAYLIB_ATLAS_PAGE_SIZE 1024
+#endif
+#ifndef CLAY_RAYLIB_ATLAS_MAX_PAGES
+#define CLAY_RAYLIB_ATLAS_MAX_PAGES 4
+#endif
+// Textures with a side larger than this keep drawing from their own texture
+#ifndef CLAY_RAYLIB_ATLAS_MAX_IMAGE_SIZE
+#define CLAY_RAYLIB_ATLAS_MAX_IMAGE_SIZE 256
+#endif
+// Must be a power of two, at most half of it can be registered
+#define CLAY_RAYLIB_ATLAS_ENTRY_SLOTS 512
 
-// Call after closing the window to clean up the render buffer
-void Clay_Raylib_Close()
+typedef struct
+{
+    Image image;
+    Texture2D texture;
+    Clay_AtlasPacker packer;
+    bool dirty;
+} Raylib_AtlasPage;
+
+typedef struct
+{
+    // The Texture2D pointer used as imageData, NULL for an empty slot
+    const void *key;
+    int page;
+    Rectangle source;
+} Raylib_AtlasEntry;
+
+static Raylib_AtlasPage Raylib_atlasPages[CLAY_RAYLIB_ATLAS_MAX_PAGES];
+static int Raylib_atlasPageCount = 0;
+static Raylib_AtlasEntry Raylib_atlasEntries[CLAY_RAYLIB_ATLAS_ENTRY_SLOTS];
+static int Raylib_atlasEntryCount = 0;
+
+// Returns the entry slot for key, which is empty if the key was never registered
+static Raylib_AtlasEntry *Raylib_AtlasSlot(const void *key)
+{
+    uintptr_t hash = (uintptr_t)key;
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3b;
+    hash ^= hash >> 16;
+    for (uintptr_t i = hash;; i++) {
+        Raylib_AtlasEntry *entry = &Raylib_atlasEntries[i & (CLAY_RAYLIB_ATLAS_ENTRY_SLOTS - 1)];
+        if (entry->key == key || entry->key == NULL) return entry;
+    }
+}
+
+// Copies a texture into an atlas page. Later IMAGE commands whose imageData is this texture
+// pointer draw from the atlas instead. The texture must stay alive and is not modified.
+// Returns false if the texture is too large or the atlas is full, it is then drawn as before.
+bool Clay_Raylib_AtlasRegister(Texture2D *texture)
+{
+    Raylib_AtlasEntry *entry = Raylib_AtlasSlot(texture);
+    if (entry->key) return true;
+    if (texture->width > CLAY_RAYLIB_ATLAS_MAX_IMAGE_SIZE || texture->height > CLAY_RAYLIB_ATLAS_MAX_IMAGE_SIZE) return false;
+    if (Raylib_atlasEntryCount >= CLAY_RAYLIB_ATLAS_ENTRY_SLOTS / 2) return false;
+
+    Clay_AtlasRect rect;
+    int page = 0;
+    while (page < Raylib_atlasPageCount && !Clay_AtlasPacker_Pack(&Raylib_atlasPages[page].packer, texture->width, texture->height, &rect)) {
+        page++;
+    }
+    if (page == Raylib_atlasPageCount) {
+        if (page == CLAY_RAYLIB_ATLAS_MAX_PAGES) return false;
+        Raylib_AtlasPage *newPage = &Raylib_atlasPages[Raylib_atlasPageCount++];
+        newPage->image = GenImageColor(CLAY_RAYLIB_ATLAS_PAGE_SIZE, CLAY_RAYLIB_ATLAS_PAGE_SIZE, BLANK);
+        newPage->texture = (Texture2D) { 0 };
+        Clay_AtlasPacker_Init(&newPage->packer, CLAY_RAYLIB_ATLAS_PAGE_SIZE, CLAY_RAYLIB_ATLAS_PAGE_SIZE, 1);
+        if (!Clay_AtlasPacker_Pack(&newPage->packer, texture->width, texture->height, &rect)) return false;
+    }
+
+    Image pixels = LoadImageFromTexture(*texture);
+    ImageFormat(&pixels, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    Raylib_AtlasPage *atlasPage = &Raylib_atlasPages[page];
+    for (int row = 0; row < rect.height; row++) {
+        memcpy((unsigned char *)atlasPage->image.data + ((rect.y + row) * atlasPage->image.width + rect.x) * 4,
+               (unsigned char *)pixels.data + row * pixels.width * 4,
+               rect.width * 4);
+    }
+    UnloadImage(pixels);
+    atlasPage->dirty = true;
+
+    entry->key = texture;
+    entry->page = page;
+    entry->source = (Rectangle) { (float)rect.x, (float)rect.y, (float)rect.width, (float)rect.height };
+    Raylib_atlasEntryCount++;
+    return true;
+}
+
+// Unloads every atlas page and forgets all registered textures
+void Clay_Raylib_AtlasClear()
 {
-    if(temp_render_buffer) free(temp_render_buffer);
-    temp_render_buffer_len = 0;
+    for (int i = 0; i < Raylib_atlasPageCount; i++) {
+        UnloadImage(Raylib_atlasPages[i].image);
+        if (Raylib_atlasPages[i].texture.id != 0) UnloadTexture(Raylib_atlasPages[i].texture);
+    }
+    Raylib_atlasPageCount = 0;
+    memset(Raylib_atlasEntries, 0, sizeof(Raylib_atlasEntries));
+    Raylib_atlasEntryCount = 0;
+}
 
+// Uploads pages that changed since the last frame, before any of them is queued for drawing
+static void Raylib_AtlasUpload(void)
+{
+    for (int i = 0; i < Raylib_atlasPageCount; i++) {
+        Raylib_AtlasPage *page = &Raylib_atlasPages[i];
+        if (!page->dirty) continue;
+        if (page->texture.id == 0) page->texture = LoadTextureFromImage(page->image);
+        else UpdateTexture(page->texture, page->image.data);
+        page->dirty = false;
+    }
+}
+
+void Clay_Raylib_LayerClear();
+
+void Clay_Raylib_Close()
+{
+    Clay_Raylib_AtlasClear();
+    Clay_Raylib_LayerClear();
     CloseWindow();
 }
 
+// Font atlas texture of the open glyph batch, 0 when no batch is open
+static unsigned int Raylib_textBatchTexture = 0;
 
-void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts)
+// Ends the open glyph batch. rlgl only issues a draw call for it once the
+// texture or scissor changes, or the frame ends.
+static void Raylib_EndTextBatch(void)
 {
-    for (int j = 0; j < renderCommands.length; j++)
+    if (Raylib_textBatchTexture == 0) return;
+    rlEnd();
+    rlSetTexture(0);
+    Raylib_textBatchTexture = 0;
+}
+
+// Returns the glyph index of a codepoint. The printable ASCII range of fonts loaded with the
+// default charset is indexed directly, which avoids GetGlyphIndex's linear search.
+static inline int Raylib_GlyphIndex(Font font, int codepoint)
+{
+    int index = codepoint - 32;
+    if (index >= 0 && index < font.glyphCount && font.glyphs[index].value == codepoint) return index;
+    return GetGlyphIndex(font, codepoint);
+}
+
+// Same layout as DrawTextEx, but reads the slice in place and appends every glyph quad to the
+// glyph batch that is open for the font's atlas, instead of one DrawTexturePro per glyph.
+static void Raylib_DrawTextSlice(Font font, Clay_StringSlice text, Vector2 position, float fontSize, float spacing, Color tint)
+{
+    if (font.texture.id == 0) font = GetFontDefault();
+    if (Raylib_textBatchTexture != font.texture.id) {
+        Raylib_EndTextBatch();
+        rlSetTexture(font.texture.id);
+        rlBegin(RL_QUADS);
+        Raylib_textBatchTexture = font.texture.id;
+    }
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+
+    const float scaleFactor = fontSize/(float)font.baseSize;
+    const float padding = (float)font.glyphPadding;
+    const float textureWidth = (float)font.texture.width;
+    const float textureHeight = (float)font.texture.height;
+    float textOffsetX = 0.0f;
+    float textOffsetY = 0.0f;
+
+    for (int i = 0; i < text.length;) {
+        int codepoint = (unsigned char)text.chars[i];
+        int codepointByteCount = 1;
+        if (codepoint >= 0x80) {
+            // Only decode sequences that fit in the slice, GetCodepointNext may read up to 4 bytes
+            int sequenceLength = codepoint >= 0xF0 ? 4 : codepoint >= 0xE0 ? 3 : 2;
+            if (i + sequenceLength <= text.length) codepoint = GetCodepointNext(&text.chars[i], &codepointByteCount);
+            else codepoint = '?';
+        }
+        i += codepointByteCount;
+
+        if (codepoint == '\n') {
+            textOffsetY += fontSize + 2;
+            textOffsetX = 0.0f;
+            continue;
+        }
+
+        int index = Raylib_GlyphIndex(font, codepoint);
+        GlyphInfo glyph = font.glyphs[index];
+        Rectangle source = font.recs[index];
+        if (codepoint != ' ' && codepoint != '\t') {
+            rlCheckRenderBatchLimit(4);
+            float x = position.x + textOffsetX + (glyph.offsetX - padding)*scaleFactor;
+            float y = position.y + textOffsetY + (glyph.offsetY - padding)*scaleFactor;
+            float width = (source.width + 2.0f*padding)*scaleFactor;
+            float height = (source.height + 2.0f*padding)*scaleFactor;
+            float u0 = (source.x - padding)/textureWidth;
+            float v0 = (source.y - padding)/textureHeight;
+            float u1 = (source.x + source.width + padding)/textureWidth;
+            float v1 = (source.y + source.height + padding)/textureHeight;
+
+            rlTexCoord2f(u0, v0); rlVertex2f(x, y);
+            rlTexCoord2f(u0, v1); rlVertex2f(x, y + height);
+            rlTexCoord2f(u1, v1); rlVertex2f(x + width, y + height);
+            rlTexCoord2f(u1, v0); rlVertex2f(x + width, y);
+        }
+
+        if (glyph.advanceX == 0) textOffsetX += source.width*scaleFactor + spacing;
+        else textOffsetX += (float)glyph.advanceX*scaleFactor + spacing;
+    }
+}
+
+
+// Scissor set by the last SCISSOR_START, reapplied after drawing into a layer texture
+static bool Raylib_scissorActive = false;
+static Rectangle Raylib_scissorBox;
+
+// rootBox is the first command's box, the custom 3D model element scales with it
+static void Raylib_RenderCommand(Clay_RenderCommand *renderCommand, Font* fonts, Clay_BoundingBox rootBox)
+{
+    Clay_BoundingBox boundingBox = renderCommand->boundingBox;
+    // Consecutive text commands share one glyph batch, anything else closes it
+    if (renderCommand->commandType != CLAY_RENDER_COMMAND_TYPE_TEXT) {
+        Raylib_EndTextBatch();
+    }
+    switch (renderCommand->commandType)
     {
-        Clay_RenderCommand *renderCommand = Clay_RenderCommandArray_Get(&renderCommands, j);
-        Clay_BoundingBox boundingBox = renderCommand->boundingBox;
-        switch (renderCommand->commandType)
-        {
-            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
-                Clay_TextRenderData *textData = &renderCommand->renderData.text;
-                Font fontToUse = fonts[textData->fontId];
-    
-                int strlen = textData->stringContents.length + 1;
-    
-                if(strlen > temp_render_buffer_len) {
-                    // Grow the temp buffer if we need a larger string
-                    if(temp_render_buffer) free(temp_render_buffer);
-                    temp_render_buffer = (char*)malloc(strlen);
-                    temp_render_buffer_len = strlen;
-                }
-    
-                // Raylib uses standard C strings so isn't compatible with cheap slices, we need to clone the string to append null terminator
-                memcpy(temp_render_buffer, textData->stringContents.chars, textData->stringContents.length);
-                temp_render_buffer[textData->stringContents.length] = '\0';
-                DrawTextEx(fontToUse, temp_render_buffer, (Vector2){boundingBox.x, boundingBox.y}, (float)textData->fontSize, (float)textData->letterSpacing, CLAY_COLOR_TO_RAYLIB_COLOR(textData->textColor));
-    
-                break;
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+            Clay_TextRenderData *textData = &renderCommand->renderData.text;
+            Font fontToUse = fonts[textData->fontId];
+            Raylib_DrawTextSlice(fontToUse, textData->stringContents, (Vector2){boundingBox.x, boundingBox.y}, (float)textData->fontSize, (float)textData->letterSpacing, CLAY_COLOR_TO_RAYLIB_COLOR(textData->textColor));
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+            Texture2D imageTexture = *(Texture2D *)renderCommand->renderData.image.imageData;
+            Clay_Color tintColor = renderCommand->renderData.image.backgroundColor;
+            if (tintColor.r == 0 && tintColor.g == 0 && tintColor.b == 0 && tintColor.a == 0) {
+                tintColor = (Clay_Color) { 255, 255, 255, 255 };
             }
-            case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
-                Texture2D imageTexture = *(Texture2D *)renderCommand->renderData.image.imageData;
-                Clay_Color tintColor = renderCommand->renderData.image.backgroundColor;
-                if (tintColor.r == 0 && tintColor.g == 0 && tintColor.b == 0 && tintColor.a == 0) {
-                    tintColor = (Clay_Color) { 255, 255, 255, 255 };
-                }
-                DrawTextureEx(
-                    imageTexture,
-                    (Vector2){boundingBox.x, boundingBox.y},
+            Raylib_AtlasEntry *atlasEntry = Raylib_AtlasSlot(renderCommand->renderData.image.imageData);
+            if (atlasEntry->key) {
+                float scale = boundingBox.width / atlasEntry->source.width;
+                DrawTexturePro(
+                    Raylib_atlasPages[atlasEntry->page].texture,
+                    atlasEntry->source,
+                    (Rectangle) { boundingBox.x, boundingBox.y, boundingBox.width, atlasEntry->source.height * scale },
+                    (Vector2) { 0, 0 },
                     0,
-                    boundingBox.width / (float)imageTexture.width,
                     CLAY_COLOR_TO_RAYLIB_COLOR(tintColor));
                 break;
             }
-            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
-                BeginScissorMode((int)roundf(boundingBox.x), (int)roundf(boundingBox.y), (int)roundf(boundingBox.width), (int)roundf(boundingBox.height));
-                break;
+            DrawTextureEx(
+                imageTexture,
+                (Vector2){boundingBox.x, boundingBox.y},
+                0,
+                boundingBox.width / (float)imageTexture.width,
+                CLAY_COLOR_TO_RAYLIB_COLOR(tintColor));
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+            Raylib_scissorActive = true;
+            Raylib_scissorBox = (Rectangle) { roundf(boundingBox.x), roundf(boundingBox.y), roundf(boundingBox.width), roundf(boundingBox.height) };
+            BeginScissorMode((int)Raylib_scissorBox.x, (int)Raylib_scissorBox.y, (int)Raylib_scissorBox.width, (int)Raylib_scissorBox.height);
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+            Raylib_scissorActive = false;
+            EndScissorMode();
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+            Clay_RectangleRenderData *config = &renderCommand->renderData.rectangle;
+            if (config->cornerRadius.topLeft > 0) {
+                float radius = (config->cornerRadius.topLeft * 2) / (float)((boundingBox.width > boundingBox.height) ? boundingBox.height : boundingBox.width);
+                DrawRectangleRounded((Rectangle) { boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height }, radius, 8, CLAY_COLOR_TO_RAYLIB_COLOR(config->backgroundColor));
+            } else {
+                DrawRectangle(boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height, CLAY_COLOR_TO_RAYLIB_COLOR(config->backgroundColor));
             }
-            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
-                EndScissorMode();
-                break;
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+            Clay_BorderRenderData *config = &renderCommand->renderData.border;
+            // Left border
+            if (config->width.left > 0) {
+                DrawRectangle((int)roundf(boundingBox.x), (int)roundf(boundingBox.y + config->cornerRadius.topLeft), (int)config->width.left, (int)roundf(boundingBox.height - config->cornerRadius.topLeft - config->cornerRadius.bottomLeft), CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
             }
-            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
-                Clay_RectangleRenderData *config = &renderCommand->renderData.rectangle;
-                if (config->cornerRadius.topLeft > 0) {
-                    float radius = (config->cornerRadius.topLeft * 2) / (float)((boundingBox.width > boundingBox.height) ? boundingBox.height : boundingBox.width);
-                    DrawRectangleRounded((Rectangle) { boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height }, radius, 8, CLAY_COLOR_TO_RAYLIB_COLOR(config->backgroundColor));
-                } else {
-                    DrawRectangle(boundingBox.x, boundingBox.y, boundingBox.width, boundingBox.height, CLAY_COLOR_TO_RAYLIB_COLOR(config->backgroundColor));
-                }
-                break;
+            // Right border
+            if (config->width.right > 0) {
+                DrawRectangle((int)roundf(boundingBox.x + boundingBox.width - config->width.right), (int)roundf(boundingBox.y + config->cornerRadius.topRight), (int)config->width.right, (int)roundf(boundingBox.height - config->cornerRadius.topRight - config->cornerRadius.bottomRight), CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
             }
-            case CLAY_RENDER_COMMAND_TYPE_BORDER: {
-                Clay_BorderRenderData *config = &renderCommand->renderData.border;
-                // Left border
-                if (config->width.left > 0) {
-                    DrawRectangle((int)roundf(boundingBox.x), (int)roundf(boundingBox.y + config->cornerRadius.topLeft), (int)config->width.left, (int)roundf(boundingBox.height - config->cornerRadius.topLeft - config->cornerRadius.bottomLeft), CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
-                }
-                // Right border
-                if (config->width.right > 0) {
-                    DrawRectangle((int)roundf(boundingBox.x + boundingBox.width - config->width.right), (int)roundf(boundingBox.y + config->cornerRadius.topRight), (int)config->width.right, (int)roundf(boundingBox.height - config->cornerRadius.topRight - config->cornerRadius.bottomRight), CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
-                }
-                // Top border
-                if (config->width.top > 0) {
-                    DrawRectangle((int)roundf(boundingBox.x + config->cornerRadius.topLeft), (int)roundf(boundingBox.y), (int)roundf(boundingBox.width - config->cornerRadius.topLeft - config->cornerRadius.topRight), (int)config->width.top, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
-                }
-                // Bottom border
-                if (config->width.bottom > 0) {
-                    DrawRectangle((int)roundf(boundingBox.x + config->cornerRadius.bottomLeft), (int)roundf(boundingBox.y + boundingBox.height - config->width.bottom), (int)roundf(boundingBox.width - config->cornerRadius.bottomLeft - config->cornerRadius.bottomRight), (int)config->width.bottom, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
-                }
-                if (config->cornerRadius.topLeft > 0) {
-                    DrawRing((Vector2) { roundf(boundingBox.x + config->cornerRadius.topLeft), roundf(boundingBox.y + config->cornerRadius.topLeft) }, roundf(config->cornerRadius.topLeft - config->width.top), config->cornerRadius.topLeft, 180, 270, 10, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
-                }
-                if (config->cornerRadius.topRight > 0) {
-                    DrawRing((Vector2) { roundf(boundingBox.x + boundingBox.width - config->cornerRadius.topRight), roundf(boundingBox.y + config->cornerRadius.topRight) }, roundf(config->cornerRadius.topRight - config->width.top), config->cornerRadius.topRight, 270, 360, 10, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
-                }
-                if (config->cornerRadius.bottomLeft > 0) {
-                    DrawRing((Vector2) { roundf(boundingBox.x + config->cornerRadius.bottomLeft), roundf(boundingBox.y + boundingBox.height - config->cornerRadius.bottomLeft) }, roundf(config->cornerRadius.bottomLeft - config->width.top), config->cornerRadius.bottomLeft, 90, 180, 10, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
-                }
-                if (config->cornerRadius.bottomRight > 0) {
-                    DrawRing((Vector2) { roundf(boundingBox.x + boundingBox.width - config->cornerRadius.bottomRight), roundf(boundingBox.y + boundingBox.height - config->cornerRadius.bottomRight) }, roundf(config->cornerRadius.bottomRight - config->width.bottom), config->cornerRadius.bottomRight, 0.1, 90, 10, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
+            // Top border
+            if (config->width.top > 0) {
+                DrawRectangle((int)roundf(boundingBox.x + config->cornerRadius.topLeft), (int)roundf(boundingBox.y), (int)roundf(boundingBox.width - config->cornerRadius.topLeft - config->cornerRadius.topRight), (int)config->width.top, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
+            }
+            // Bottom border
+            if (config->width.bottom > 0) {
+                DrawRectangle((int)roundf(boundingBox.x + config->cornerRadius.bottomLeft), (int)roundf(boundingBox.y + boundingBox.height - config->width.bottom), (int)roundf(boundingBox.width - config->cornerRadius.bottomLeft - config->cornerRadius.bottomRight), (int)config->width.bottom, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
+            }
+            if (config->cornerRadius.topLeft > 0) {
+                DrawRing((Vector2) { roundf(boundingBox.x + config->cornerRadius.topLeft), roundf(boundingBox.y + config->cornerRadius.topLeft) }, roundf(config->cornerRadius.topLeft - config->width.top), config->cornerRadius.topLeft, 180, 270, 10, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
+            }
+            if (config->cornerRadius.topRight > 0) {
+                DrawRing((Vector2) { roundf(boundingBox.x + boundingBox.width - config->cornerRadius.topRight), roundf(boundingBox.y + config->cornerRadius.topRight) }, roundf(config->cornerRadius.topRight - config->width.top), config->cornerRadius.topRight, 270, 360, 10, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
+            }
+            if (config->cornerRadius.bottomLeft > 0) {
+                DrawRing((Vector2) { roundf(boundingBox.x + config->cornerRadius.bottomLeft), roundf(boundingBox.y + boundingBox.height - config->cornerRadius.bottomLeft) }, roundf(config->cornerRadius.bottomLeft - config->width.top), config->cornerRadius.bottomLeft, 90, 180, 10, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
+            }
+            if (config->cornerRadius.bottomRight > 0) {
+                DrawRing((Vector2) { roundf(boundingBox.x + boundingBox.width - config->cornerRadius.bottomRight), roundf(boundingBox.y + boundingBox.height - config->cornerRadius.bottomRight) }, roundf(config->cornerRadius.bottomRight - config->width.bottom), config->cornerRadius.bottomRight, 0.1, 90, 10, CLAY_COLOR_TO_RAYLIB_COLOR(config->color));
+            }
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+            Clay_CustomRenderData *config = &renderCommand->renderData.custom;
+            CustomLayoutElement *customElement = (CustomLayoutElement *)config->customData;
+            if (!customElement) break;
+            switch (customElement->type) {
+                case CUSTOM_LAYOUT_ELEMENT_TYPE_3D_MODEL: {
+                    float scaleValue = CLAY__MIN(CLAY__MIN(1, 768 / rootBox.height) * CLAY__MAX(1, rootBox.width / 1024), 1.5f);
+                    Ray positionRay = GetScreenToWorldPointWithZDistance((Vector2) { renderCommand->boundingBox.x + renderCommand->boundingBox.width / 2, renderCommand->boundingBox.y + (renderCommand->boundingBox.height / 2) + 20 }, Raylib_camera, (int)roundf(rootBox.width), (int)roundf(rootBox.height), 140);
+                    BeginMode3D(Raylib_camera);
+                        DrawModel(customElement->customData.model.model, positionRay.position, customElement->customData.model.scale * scaleValue, WHITE);        // Draw 3d model with texture
+                    EndMode3D();
+                    break;
                 }
-                break;
+                default: break;
             }
-            case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
-                Clay_CustomRenderData *config = &renderCommand->renderData.custom;
-                CustomLayoutElement *customElement = (CustomLayoutElement *)config->customData;
-                if (!customElement) continue;
-                switch (customElement->type) {
-                    case CUSTOM_LAYOUT_ELEMENT_TYPE_3D_MODEL: {
-                        Clay_BoundingBox rootBox = renderCommands.internalArray[0].boundingBox;
-                        float scaleValue = CLAY__MIN(CLAY__MIN(1, 768 / rootBox.height) * CLAY__MAX(1, rootBox.width / 1024), 1.5f);
-                        Ray positionRay = GetScreenToWorldPointWithZDistance((Vector2) { renderCommand->boundingBox.x + renderCommand->boundingBox.width / 2, renderCommand->boundingBox.y + (renderCommand->boundingBox.height / 2) + 20 }, Raylib_camera, (int)roundf(rootBox.width), (int)roundf(rootBox.height), 140);
-                        BeginMode3D(Raylib_camera);
-                            DrawModel(customElement->customData.model.model, positionRay.position, customElement->customData.model.scale * scaleValue, WHITE);        // Draw 3d model with texture
-                        EndMode3D();
-                        break;
-                    }
-                    default: break;
+            break;
+        }
+        default: {
+            printf("Error: unhandled render command.");
+            exit(1);
+        }
+    }
+}
+
+// Elements whose userData is a registered Clay_LayerConfig are drawn into a RenderTexture2D
+// once and blitted while their commands' fingerprint stays the same
+#ifndef CLAY_RAYLIB_MAX_LAYERS
+#define CLAY_RAYLIB_MAX_LAYERS 32
+#endif
+
+typedef struct
+{
+    const Clay_LayerConfig *config;
+    RenderTexture2D target;
+    uint64_t fingerprint;
+    uint64_t lastDrawnFrame;
+} Raylib_Layer;
+
+static Raylib_Layer Raylib_layers[CLAY_RAYLIB_MAX_LAYERS];
+static int Raylib_layerCount = 0;
+static uint64_t Raylib_frameIndex = 0;
+// A layer's commands moved to its texture's origin
+static Clay_RenderCommand *Raylib_layerCommands = NULL;
+static int Raylib_layerCommandCapacity = 0;
+
+// Enables caching for elements whose userData is layer, which must stay alive until it is
+// unregistered. Returns false if CLAY_RAYLIB_MAX_LAYERS layers are registered already.
+bool Clay_Raylib_LayerRegister(const Clay_LayerConfig *layer)
+{
+    for (int i = 0; i < Raylib_layerCount; i++) {
+        if (Raylib_layers[i].config == layer) return true;
+    }
+    if (Raylib_layerCount == CLAY_RAYLIB_MAX_LAYERS) return false;
+    Raylib_layers[Raylib_layerCount++] = (Raylib_Layer) { .config = layer };
+    return true;
+}
+
+// Unloads the texture of a layer and stops caching it
+void Clay_Raylib_LayerUnregister(const Clay_LayerConfig *layer)
+{
+    for (int i = 0; i < Raylib_layerCount; i++) {
+        if (Raylib_layers[i].config != layer) continue;
+        if (Raylib_layers[i].target.id != 0) UnloadRenderTexture(Raylib_layers[i].target);
+        Raylib_layers[i] = Raylib_layers[--Raylib_layerCount];
+        return;
+    }
+}
+
+// Unloads every layer texture and forgets all registered layers
+void Clay_Raylib_LayerClear()
+{
+    for (int i = 0; i < Raylib_layerCount; i++) {
+        if (Raylib_layers[i].target.id != 0) UnloadRenderTexture(Raylib_layers[i].target);
+    }
+    Raylib_layerCount = 0;
+    free(Raylib_layerCommands);
+    Raylib_layerCommands = NULL;
+    Raylib_layerCommandCapacity = 0;
+}
+
+static Raylib_Layer *Raylib_FindLayer(const void *userData)
+{
+    for (int i = 0; i < Raylib_layerCount; i++) {
+        if (Raylib_layers[i].config == userData) return &Raylib_layers[i];
+    }
+    return NULL;
+}
+
+// Draws the layer starting at renderCommands[start] from its texture, redrawing the texture
+// first if the commands changed. Returns the index after the layer.
+static int Raylib_DrawLayer(Raylib_Layer *layer, Clay_RenderCommandArray *renderCommands, int start, Font* fonts, Clay_BoundingBox rootBox)
+{
+    Clay_LayerExtent extent = Clay_Layer_Measure(renderCommands, start);
+    // Only the first run of a layer in a frame is cached, a second one means a descendant
+    // with its own userData split it
+    if (extent.width <= 0 || extent.height <= 0 || extent.width > CLAY_LAYER_MAX_SIZE || extent.height > CLAY_LAYER_MAX_SIZE
+        || layer->lastDrawnFrame == Raylib_frameIndex) {
+        for (int i = start; i < extent.end; i++) {
+            Raylib_RenderCommand(&renderCommands->internalArray[i], fonts, rootBox);
+        }
+        return extent.end;
+    }
+    layer->lastDrawnFrame = Raylib_frameIndex;
+    Raylib_EndTextBatch();
+
+    if (layer->target.id == 0 || layer->target.texture.width != extent.width || layer->target.texture.height != extent.height) {
+        if (layer->target.id != 0) UnloadRenderTexture(layer->target);
+        layer->target = LoadRenderTexture(extent.width, extent.height);
+        // Anything but the current fingerprint, so the new texture is drawn
+        layer->fingerprint = extent.fingerprint + 1;
+    }
+
+    if (layer->fingerprint != extent.fingerprint) {
+        int count = extent.end - start;
+        if (count > Raylib_layerCommandCapacity) {
+            Clay_RenderCommand *grown = (Clay_RenderCommand *)realloc(Raylib_layerCommands, count * sizeof(Clay_RenderCommand));
+            if (!grown) {
+                for (int i = start; i < extent.end; i++) {
+                    Raylib_RenderCommand(&renderCommands->internalArray[i], fonts, rootBox);
                 }
-                break;
+                return extent.end;
             }
-            default: {
-                printf("Error: unhandled render command.");
-                exit(1);
+            Raylib_layerCommands = grown;
+            Raylib_layerCommandCapacity = count;
+        }
+        memcpy(Raylib_layerCommands, renderCommands->internalArray + start, count * sizeof(Clay_RenderCommand));
+
+        // The window's scissor would clip the texture, it is reapplied afterwards
+        bool scissorActive = Raylib_scissorActive;
+        Rectangle scissorBox = Raylib_scissorBox;
+        if (scissorActive) EndScissorMode();
+        BeginTextureMode(layer->target);
+        ClearBackground(BLANK);
+        // Alpha accumulates as in a framebuffer, which leaves premultiplied colors behind
+        rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+        BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+        for (int i = 0; i < count; i++) {
+            Raylib_layerCommands[i].boundingBox.x -= extent.x;
+            Raylib_layerCommands[i].boundingBox.y -= extent.y;
+            Raylib_RenderCommand(&Raylib_layerCommands[i], fonts, rootBox);
+        }
+        Raylib_EndTextBatch();
+        if (Raylib_scissorActive) EndScissorMode();
+        EndBlendMode();
+        EndTextureMode();
+        Raylib_scissorActive = scissorActive;
+        if (scissorActive) BeginScissorMode((int)scissorBox.x, (int)scissorBox.y, (int)scissorBox.width, (int)scissorBox.height);
+        layer->fingerprint = extent.fingerprint;
+    }
+
+    // Render textures are stored upside down
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    DrawTextureRec(layer->target.texture, (Rectangle) { 0, 0, (float)extent.width, -(float)extent.height }, (Vector2) { extent.x, extent.y }, WHITE);
+    EndBlendMode();
+    return extent.end;
+}
+
+void Clay_Raylib_Render(Clay_RenderCommandArray renderCommands, Font* fonts)
+{
+    Raylib_frameIndex++;
+    Raylib_AtlasUpload();
+    if (renderCommands.length == 0) return;
+    Clay_BoundingBox rootBox = renderCommands.internalArray[0].boundingBox;
+    for (int j = 0; j < renderCommands.length;)
+    {
+        Clay_RenderCommand *renderCommand = Clay_RenderCommandArray_Get(&renderCommands, j);
+        if (renderCommand->userData && Raylib_layerCount > 0) {
+            Raylib_Layer *layer = Raylib_FindLayer(renderCommand->userData);
+            if (layer && layer->config->cacheAsLayer) {
+                j = Raylib_DrawLayer(layer, &renderCommands, j, fonts, rootBox);
+                continue;
             }
         }
+        Raylib_RenderCommand(renderCommand, fonts, rootBox);
+        j++;
     }
+    Raylib_EndTextBatch();
 }
@@ -23,20 +23,37 @@ typedef struct
 } SDL2_Font;
 
 
+// SDL_ttf needs null terminated strings. Slices are copied into this buffer, which only grows,
+// so once it fits the longest string no more allocations happen. Freed by Clay_SDL2_ClearTextCache.
+static char *SDL2_scratchBuffer = NULL;
+static int32_t SDL2_scratchBufferCapacity = 0;
+
+static const char *SDL2_TerminatedString(Clay_StringSlice text)
+{
+    if (text.length + 1 > SDL2_scratchBufferCapacity) {
+        int32_t capacity = SDL_max(text.length + 1, SDL2_scratchBufferCapacity * 2);
+        char *grown = (char *)realloc(SDL2_scratchBuffer, capacity);
+        if (!grown) return NULL;
+        SDL2_scratchBuffer = grown;
+        SDL2_scratchBufferCapacity = capacity;
+    }
+    memcpy(SDL2_scratchBuffer, text.chars, text.length);
+    SDL2_scratchBuffer[text.length] = '\0';
+    return SDL2_scratchBuffer;
+}
+
 static Clay_Dimensions SDL2_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData)
 {
     SDL2_Font *fonts = (SDL2_Font*)userData;
 
     TTF_Font *font = fonts[config->fontId].font;
-    char *chars = (char *)calloc(text.length + 1, 1);
-    memcpy(chars, text.chars, text.length);
+    const char *chars = SDL2_TerminatedString(text);
     int width = 0;
     int height = 0;
-    if (TTF_SizeUTF8(font, chars, &width, &height) < 0) {
+    if (!chars || TTF_SizeUTF8(font, chars, &width, &height) < 0) {
         fprintf(stderr, "Error: could not measure text: %s\n", TTF_GetError());
-        exit(1);
+        return (Clay_Dimensions) { 0, 0 };
     }
-    free(chars);
     return (Clay_Dimensions) {
             .width = (float)width,
             .height = (float)height,
@@ -266,10 +283,120 @@ static void SDL_RenderCornerBorder(SDL_Renderer *renderer, Clay_BoundingBox* bou
     SDL_RenderGeometry(renderer, NULL, vertices, vertexCount, indices, indexCount);
 }
 
+// Rendered text textures kept across frames, keyed by font, string and color. Slots are
+// replaced in place, so neither hits nor misses allocate once every slot's string buffer is
+// large enough.
+#ifndef CLAY_SDL2_TEXT_CACHE_SLOTS
+#define CLAY_SDL2_TEXT_CACHE_SLOTS 1024 // Must be a power of two
+#endif
+// How many slots a string may live in, the least recently used of them is replaced on a miss
+#define CLAY_SDL2_TEXT_CACHE_PROBES 8
+
+typedef struct
+{
+    uint64_t hash;
+    TTF_Font *font;
+    Clay_Color color;
+    char *chars;
+    int32_t length;
+    int32_t capacity;
+    SDL_Texture *texture;
+    uint32_t lastUsedFrame;
+} SDL2_CachedText;
+
+static SDL2_CachedText SDL2_textCache[CLAY_SDL2_TEXT_CACHE_SLOTS];
+static uint32_t SDL2_frameIndex = 0;
+
+static uint64_t SDL2_HashText(TTF_Font *font, Clay_StringSlice text, Clay_Color color)
+{
+    // FNV-1a over the string, then the font pointer and color
+    uint64_t hash = 14695981039346656037ull;
+    for (int32_t i = 0; i < text.length; i++) {
+        hash ^= (uint8_t)text.chars[i];
+        hash *= 1099511628211ull;
+    }
+    hash ^= (uint64_t)(uintptr_t)font;
+    hash *= 1099511628211ull;
+    hash ^= ((uint64_t)color.r << 24) | ((uint64_t)color.g << 16) | ((uint64_t)color.b << 8) | (uint64_t)color.a;
+    hash *= 1099511628211ull;
+    return hash;
+}
+
+// Returns the texture for this text, rendering it only if it is not cached
+static SDL_Texture *SDL2_GetTextTexture(SDL_Renderer *renderer, TTF_Font *font, Clay_TextRenderData *config)
+{
+    Clay_StringSlice text = config->stringContents;
+    uint64_t hash = SDL2_HashText(font, text, config->textColor);
+    SDL2_CachedText *victim = NULL;
+    for (int probe = 0; probe < CLAY_SDL2_TEXT_CACHE_PROBES; probe++) {
+        SDL2_CachedText *entry = &SDL2_textCache[(hash + probe) & (CLAY_SDL2_TEXT_CACHE_SLOTS - 1)];
+        if (!entry->texture) {
+            victim = entry;
+            break;
+        }
+        if (entry->hash == hash && entry->font == font && entry->length == text.length
+            && memcmp(&entry->color, &config->textColor, sizeof(Clay_Color)) == 0
+            && memcmp(entry->chars, text.chars, text.length) == 0) {
+            entry->lastUsedFrame = SDL2_frameIndex;
+            return entry->texture;
+        }
+        if (!victim || SDL2_frameIndex - entry->lastUsedFrame > SDL2_frameIndex - victim->lastUsedFrame) {
+            victim = entry;
+        }
+    }
+
+    const char *chars = SDL2_TerminatedString(text);
+    if (!chars) return NULL;
+    SDL_Surface *surface = TTF_RenderUTF8_Blended(font, chars, (SDL_Color) {
+        .r = (Uint8)config->textColor.r,
+        .g = (Uint8)config->textColor.g,
+        .b = (Uint8)config->textColor.b,
+        .a = (Uint8)config->textColor.a,
+    });
+    if (!surface) return NULL;
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!texture) return NULL;
+
+    if (text.length > victim->capacity) {
+        char *grown = (char *)realloc(victim->chars, text.length);
+        if (!grown) {
+            SDL_DestroyTexture(texture);
+            return NULL;
+        }
+        victim->chars = grown;
+        victim->capacity = text.length;
+    }
+    if (victim->texture) SDL_DestroyTexture(victim->texture);
+    memcpy(victim->chars, text.chars, text.length);
+    victim->hash = hash;
+    victim->font = font;
+    victim->color = config->textColor;
+    victim->length = text.length;
+    victim->texture = texture;
+    victim->lastUsedFrame = SDL2_frameIndex;
+    return texture;
+}
+
+// Destroys every cached text texture and frees the string buffers. Call before closing the
+// fonts or destroying the renderer.
+static void Clay_SDL2_ClearTextCache(void)
+{
+    for (int i = 0; i < CLAY_SDL2_TEXT_CACHE_SLOTS; i++) {
+        if (SDL2_textCache[i].texture) SDL_DestroyTexture(SDL2_textCache[i].texture);
+        free(SDL2_textCache[i].chars);
+    }
+    memset(SDL2_textCache, 0, sizeof(SDL2_textCache));
+    free(SDL2_scratchBuffer);
+    SDL2_scratchBuffer = NULL;
+    SDL2_scratchBufferCapacity = 0;
+}
+
 SDL_Rect currentClippingRectangle;
 
 static void Clay_SDL2_Render(SDL_Renderer *renderer, Clay_RenderCommandArray renderCommands, SDL2_Font *fonts)
 {
+    SDL2_frameIndex++;
     for (uint32_t i = 0; i < renderCommands.length; i++)
     {
         Clay_RenderCommand *renderCommand = Clay_RenderCommandArray_Get(&renderCommands, i);
@@ -296,16 +423,9 @@ static void Clay_SDL2_Render(SDL_Renderer *renderer, Clay_RenderCommandArray ren
             }
             case CLAY_RENDER_COMMAND_TYPE_TEXT: {
                 Clay_TextRenderData *config = &renderCommand->renderData.text;
-                char *cloned = (char *)calloc(config->stringContents.length + 1, 1);
-                memcpy(cloned, config->stringContents.chars, config->stringContents.length);
                 TTF_Font* font = fonts[config->fontId].font;
-                SDL_Surface *surface = TTF_RenderUTF8_Blended(font, cloned, (SDL_Color) {
-                    .r = (Uint8)config->textColor.r,
-                    .g = (Uint8)config->textColor.g,
-                    .b = (Uint8)config->textColor.b,
-                    .a = (Uint8)config->textColor.a,
-                });
-                SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+                SDL_Texture *texture = SDL2_GetTextTexture(renderer, font, config);
+                if (!texture) break;
 
                 SDL_Rect destination = (SDL_Rect){
                     .x = (int)boundingBox.x,
@@ -314,10 +434,6 @@ static void Clay_SDL2_Render(SDL_Renderer *renderer, Clay_RenderCommandArray ren
                     .h = (int)boundingBox.height,
                 };
                 SDL_RenderCopy(renderer, texture, NULL, &destination);
-
-                SDL_DestroyTexture(texture);
-                SDL_FreeSurface(surface);
-                free(cloned);
                 break;
             }
             case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
@@ -6,15 +6,94 @@
 #include <SDL3/SDL_main.h>
 #include <SDL3_image/SDL_image.h>
 #include <SDL3_ttf/SDL_ttf.h>
+#include <list>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../clay.h"
+#include "../clay_atlas.h"
+#include "../clay_layer.h"
+
+// A shaped TTF_Text kept alive across frames, keyed by font, string contents
+// and color
+struct SDL_Clay_CachedText {
+  uint64_t hash;
+  TTF_Font *font;
+  Clay_Color color;
+  std::string contents;
+  TTF_Text *text;
+};
+
+// A texture uploaded from an IMAGE command's SDL_Surface. The surface's
+// shape is remembered so reallocated pixels are noticed, and version is
+// bumped by SDL_Clay_InvalidateImageTexture for in-place pixel edits.
+struct SDL_Clay_CachedImage {
+  SDL_Texture *texture;
+  int w, h;
+  void *pixels;
+  SDL_PixelFormat format;
+  uint32_t version;
+  uint32_t uploadedVersion;
+  uint64_t lastUsedFrame;
+};
+
+// A shared texture that small registered images are packed into
+struct SDL_Clay_AtlasPage {
+  SDL_Surface *surface;
+  SDL_Texture *texture;
+  Clay_AtlasPacker packer;
+  bool dirty;
+};
+
+struct SDL_Clay_AtlasEntry {
+  size_t page;
+  SDL_Rect source;
+};
+
+// The offscreen texture of a registered Clay_LayerConfig and the fingerprint
+// of the commands last drawn into it
+struct SDL_Clay_Layer {
+  SDL_Texture *texture;
+  int w, h;
+  uint64_t fingerprint;
+  uint64_t lastDrawnFrame;
+};
 
 class Clay_SDL3RendererData {
 public:
   SDL_Renderer *renderer;
   TTF_TextEngine *textEngine;
   TTF_Font **fonts;
+  // Maximum number of TTF_Text objects kept between frames, least recently
+  // used ones are destroyed first. 0 creates and destroys text every draw.
+  size_t textCacheBudget = 1024;
+  // Most recently used first
+  std::list<SDL_Clay_CachedText> textCache;
+  std::unordered_map<uint64_t, std::list<SDL_Clay_CachedText>::iterator>
+      textCacheIndex;
+  // Textures for IMAGE commands, uploaded once per surface version
+  std::unordered_map<SDL_Surface *, SDL_Clay_CachedImage> imageCache;
+  // Incremented by every SDL_Clay_RenderClayCommands call
+  uint64_t frameIndex = 0;
+  // Geometry queued since the last flush, all sampling batchTexture (nullptr
+  // for solid fills). Cleared but not freed on flush, so frames after the
+  // first do not allocate.
+  std::vector<SDL_Vertex> batchVertices;
+  std::vector<int> batchIndices;
+  SDL_Texture *batchTexture = nullptr;
+  // Images registered with SDL_Clay_AtlasRegisterImage, drawn from atlas pages
+  // so consecutive ones join the same batch
+  std::vector<SDL_Clay_AtlasPage> atlasPages;
+  std::unordered_map<SDL_Surface *, SDL_Clay_AtlasEntry> atlasEntries;
+  // cos/sin of i * 90deg / segments for i = 0..segments, keyed by segments
+  std::unordered_map<int, std::vector<SDL_FPoint>> quarterCircles;
+  // Layers registered with SDL_Clay_RegisterLayer
+  std::unordered_map<const void *, SDL_Clay_Layer> layers;
+  // A layer's commands moved to its texture's origin, reused between redraws
+  std::vector<Clay_RenderCommand> layerCommands;
+  // Number of layer redraws, for checking that static panels stay cached
+  uint64_t layerRedrawCount = 0;
 };
 
 /* Global for convenience. Even in 4K this is enough for smooth curves (low
@@ -22,16 +101,110 @@ public:
  * as jagged curves) */
 static int NUM_CIRCLE_SEGMENTS = 16;
 
-// all rendering is performed by a single SDL call, avoiding multiple RenderRect
-// + plumbing choice for circles.
-static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData,
-                                           const SDL_FRect rect,
-                                           const float cornerRadius,
-                                           const Clay_Color _color) {
-  const SDL_FColor color = {_color.r / 255.0f, _color.g / 255.0f,
-                            _color.b / 255.0f, _color.a / 255.0f};
+// Side of a square atlas page, and the largest image side that is packed
+static const int SDL_CLAY_ATLAS_PAGE_SIZE = 1024;
+static const int SDL_CLAY_ATLAS_MAX_IMAGE_SIZE = 256;
+
+// Returns the unit quarter circle from 0 to 90 degrees split into the given
+// number of segments, computing it only the first time a count is used.
+static const std::vector<SDL_FPoint> &
+SDL_Clay_GetQuarterCircle(Clay_SDL3RendererData *rendererData,
+                          const int segments) {
+  std::vector<SDL_FPoint> &points = rendererData->quarterCircles[segments];
+  if (points.empty()) {
+    const float step = (SDL_PI_F / 2) / static_cast<float>(segments);
+    points.resize(segments + 1);
+    for (int i = 0; i <= segments; i++) {
+      points[i] = SDL_FPoint{SDL_cosf(i * step), SDL_sinf(i * step)};
+    }
+  }
+  return points;
+}
+
+static SDL_FColor SDL_Clay_ToFColor(const Clay_Color color) {
+  return SDL_FColor{color.r / 255.0f, color.g / 255.0f, color.b / 255.0f,
+                    color.a / 255.0f};
+}
+
+// Draws all queued geometry with a single SDL_RenderGeometry call. Must run
+// before anything else is drawn or the clip rect changes.
+static void SDL_Clay_FlushGeometry(Clay_SDL3RendererData *rendererData) {
+  if (rendererData->batchIndices.empty()) {
+    return;
+  }
+  SDL_SetRenderDrawBlendMode(rendererData->renderer, SDL_BLENDMODE_BLEND);
+  SDL_RenderGeometry(rendererData->renderer, rendererData->batchTexture,
+                     rendererData->batchVertices.data(),
+                     static_cast<int>(rendererData->batchVertices.size()),
+                     rendererData->batchIndices.data(),
+                     static_cast<int>(rendererData->batchIndices.size()));
+  rendererData->batchVertices.clear();
+  rendererData->batchIndices.clear();
+}
 
-  int indexCount = 0, vertexCount = 0;
+// Flushes the batch if it samples a different texture than the next geometry
+static void SDL_Clay_UseBatchTexture(Clay_SDL3RendererData *rendererData,
+                                     SDL_Texture *texture) {
+  if (rendererData->batchTexture != texture) {
+    SDL_Clay_FlushGeometry(rendererData);
+    rendererData->batchTexture = texture;
+  }
+}
+
+static void SDL_Clay_PushFillRect(Clay_SDL3RendererData *rendererData,
+                                  const SDL_FRect rect,
+                                  const Clay_Color _color) {
+  SDL_Clay_UseBatchTexture(rendererData, nullptr);
+  const SDL_FColor color = SDL_Clay_ToFColor(_color);
+  std::vector<SDL_Vertex> &vertices = rendererData->batchVertices;
+  const int base = static_cast<int>(vertices.size());
+
+  vertices.push_back(SDL_Vertex{{rect.x, rect.y}, color, {0, 0}});
+  vertices.push_back(SDL_Vertex{{rect.x + rect.w, rect.y}, color, {0, 0}});
+  vertices.push_back(
+      SDL_Vertex{{rect.x + rect.w, rect.y + rect.h}, color, {0, 0}});
+  vertices.push_back(SDL_Vertex{{rect.x, rect.y + rect.h}, color, {0, 0}});
+
+  for (int index : {0, 1, 3, 1, 2, 3}) {
+    rendererData->batchIndices.push_back(base + index);
+  }
+}
+
+// Queues dest textured with the source pixels of an atlas page
+static void SDL_Clay_PushAtlasImage(Clay_SDL3RendererData *rendererData,
+                                    const SDL_Clay_AtlasPage &page,
+                                    const SDL_Rect source, const SDL_FRect dest) {
+  SDL_Clay_UseBatchTexture(rendererData, page.texture);
+  const SDL_FColor white = {1, 1, 1, 1};
+  const float size = static_cast<float>(SDL_CLAY_ATLAS_PAGE_SIZE);
+  const float u0 = source.x / size, v0 = source.y / size;
+  const float u1 = (source.x + source.w) / size;
+  const float v1 = (source.y + source.h) / size;
+  std::vector<SDL_Vertex> &vertices = rendererData->batchVertices;
+  const int base = static_cast<int>(vertices.size());
+
+  vertices.push_back(SDL_Vertex{{dest.x, dest.y}, white, {u0, v0}});
+  vertices.push_back(SDL_Vertex{{dest.x + dest.w, dest.y}, white, {u1, v0}});
+  vertices.push_back(
+      SDL_Vertex{{dest.x + dest.w, dest.y + dest.h}, white, {u1, v1}});
+  vertices.push_back(SDL_Vertex{{dest.x, dest.y + dest.h}, white, {u0, v1}});
+
+  for (int index : {0, 1, 3, 1, 2, 3}) {
+    rendererData->batchIndices.push_back(base + index);
+  }
+}
+
+// Queues a rounded rectangle as a center quad, four corner fans and four edge
+// quads
+static void SDL_Clay_PushFillRoundedRect(Clay_SDL3RendererData *rendererData,
+                                         const SDL_FRect rect,
+                                         const float cornerRadius,
+                                         const Clay_Color _color) {
+  SDL_Clay_UseBatchTexture(rendererData, nullptr);
+  const SDL_FColor color = SDL_Clay_ToFColor(_color);
+  std::vector<SDL_Vertex> &vertices = rendererData->batchVertices;
+  std::vector<int> &indices = rendererData->batchIndices;
+  const int base = static_cast<int>(vertices.size());
 
   const float minRadius = SDL_min(rect.w, rect.h) / 2.0f;
   const float clampedRadius = SDL_min(cornerRadius, minRadius);
@@ -39,334 +212,659 @@ static void SDL_Clay_RenderFillRoundedRect(Clay_SDL3RendererData *rendererData,
   const int numCircleSegments =
       SDL_max(NUM_CIRCLE_SEGMENTS, static_cast<int>(clampedRadius * 0.5f));
 
-  int totalVertices = 4 + (4 * (numCircleSegments * 2)) + 2 * 4;
-  int totalIndices = 6 + (4 * (numCircleSegments * 3)) + 6 * 4;
-
-  std::vector<SDL_Vertex> vertices(totalVertices);
-  std::vector<int> indices(totalIndices);
-
   // define center rectangle
-  vertices[vertexCount++] =
-      SDL_Vertex{{rect.x + clampedRadius, rect.y + clampedRadius},
-                 color,
-                 {0, 0}}; // 0 center TL
-  vertices[vertexCount++] =
+  vertices.push_back(SDL_Vertex{{rect.x + clampedRadius, rect.y + clampedRadius},
+                                color,
+                                {0, 0}}); // 0 center TL
+  vertices.push_back(
       SDL_Vertex{{rect.x + rect.w - clampedRadius, rect.y + clampedRadius},
                  color,
-                 {1, 0}}; // 1 center TR
-  vertices[vertexCount++] = SDL_Vertex{
+                 {1, 0}}); // 1 center TR
+  vertices.push_back(SDL_Vertex{
       {rect.x + rect.w - clampedRadius, rect.y + rect.h - clampedRadius},
       color,
-      {1, 1}}; // 2 center BR
-  vertices[vertexCount++] =
+      {1, 1}}); // 2 center BR
+  vertices.push_back(
       SDL_Vertex{{rect.x + clampedRadius, rect.y + rect.h - clampedRadius},
                  color,
-                 {0, 1}}; // 3 center BL
-
-  indices[indexCount++] = 0;
-  indices[indexCount++] = 1;
-  indices[indexCount++] = 3;
-  indices[indexCount++] = 1;
-  indices[indexCount++] = 2;
-  indices[indexCount++] = 3;
-
-  // define rounded corners as triangle fans
-  const float step = (SDL_PI_F / 2) / numCircleSegments;
-  for (int i = 0; i < numCircleSegments; i++) {
-    const float angle1 = static_cast<float>(i) * step;
-    const float angle2 = (static_cast<float>(i) + 1.0f) * step;
-
-    for (int j = 0; j < 4; j++) { // Iterate over four corners
-      float cx, cy, signX, signY;
-
-      switch (j) {
-      case 0:
-        cx = rect.x + clampedRadius;
-        cy = rect.y + clampedRadius;
-        signX = -1;
-        signY = -1;
-        break; // Top-left
-      case 1:
-        cx = rect.x + rect.w - clampedRadius;
-        cy = rect.y + clampedRadius;
-        signX = 1;
-        signY = -1;
-        break; // Top-right
-      case 2:
-        cx = rect.x + rect.w - clampedRadius;
-        cy = rect.y + rect.h - clampedRadius;
-        signX = 1;
-        signY = 1;
-        break; // Bottom-right
-      case 3:
-        cx = rect.x + clampedRadius;
-        cy = rect.y + rect.h - clampedRadius;
-        signX = -1;
-        signY = 1;
-        break; // Bottom-left
-      default:
-        return;
-      }
+                 {0, 1}}); // 3 center BL
 
-      vertices[vertexCount++] =
-          SDL_Vertex{{cx + SDL_cosf(angle1) * clampedRadius * signX,
-                      cy + SDL_sinf(angle1) * clampedRadius * signY},
-                     color,
-                     {0, 0}};
-      vertices[vertexCount++] =
-          SDL_Vertex{{cx + SDL_cosf(angle2) * clampedRadius * signX,
-                      cy + SDL_sinf(angle2) * clampedRadius * signY},
-                     color,
-                     {0, 0}};
+  for (int index : {0, 1, 3, 1, 2, 3}) {
+    indices.push_back(base + index);
+  }
 
-      indices[indexCount++] = j; // Connect to corresponding
-                                 // central rectangle vertex
-      indices[indexCount++] = vertexCount - 2;
-      indices[indexCount++] = vertexCount - 1;
+  // define rounded corners as triangle fans around the center rectangle's
+  // corner vertices
+  const std::vector<SDL_FPoint> &quarter =
+      SDL_Clay_GetQuarterCircle(rendererData, numCircleSegments);
+  // Top-left, top-right, bottom-right, bottom-left, matching vertices 0..3
+  const float cornerCenters[4][2] = {
+      {rect.x + clampedRadius, rect.y + clampedRadius},
+      {rect.x + rect.w - clampedRadius, rect.y + clampedRadius},
+      {rect.x + rect.w - clampedRadius, rect.y + rect.h - clampedRadius},
+      {rect.x + clampedRadius, rect.y + rect.h - clampedRadius}};
+  const float cornerSigns[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+  for (int j = 0; j < 4; j++) {
+    const float cx = cornerCenters[j][0], cy = cornerCenters[j][1];
+    const float signX = cornerSigns[j][0], signY = cornerSigns[j][1];
+    for (int i = 0; i <= numCircleSegments; i++) {
+      vertices.push_back(
+          SDL_Vertex{{cx + quarter[i].x * clampedRadius * signX,
+                      cy + quarter[i].y * clampedRadius * signY},
+                     color,
+                     {0, 0}});
+      if (i > 0) {
+        const int vertexCount = static_cast<int>(vertices.size());
+        indices.push_back(base + j);
+        indices.push_back(vertexCount - 2);
+        indices.push_back(vertexCount - 1);
+      }
     }
   }
 
-  // Define edge rectangles
-  //  Top edge
-  vertices[vertexCount++] =
-      SDL_Vertex{{rect.x + clampedRadius, rect.y}, color, {0, 0}}; // TL
-  vertices[vertexCount++] = SDL_Vertex{
-      {rect.x + rect.w - clampedRadius, rect.y}, color, {1, 0}}; // TR
-
-  indices[indexCount++] = 0;
-  indices[indexCount++] = vertexCount - 2; // TL
-  indices[indexCount++] = vertexCount - 1; // TR
-  indices[indexCount++] = 1;
-  indices[indexCount++] = 0;
-  indices[indexCount++] = vertexCount - 1; // TR
-  // Right edge
-  vertices[vertexCount++] = SDL_Vertex{
-      {rect.x + rect.w, rect.y + clampedRadius}, color, {1, 0}}; // RT
-  vertices[vertexCount++] = SDL_Vertex{
-      {rect.x + rect.w, rect.y + rect.h - clampedRadius}, color, {1, 1}}; // RB
-
-  indices[indexCount++] = 1;
-  indices[indexCount++] = vertexCount - 2; // RT
-  indices[indexCount++] = vertexCount - 1; // RB
-  indices[indexCount++] = 2;
-  indices[indexCount++] = 1;
-  indices[indexCount++] = vertexCount - 1; // RB
-  // Bottom edge
-  vertices[vertexCount++] = SDL_Vertex{
-      {rect.x + rect.w - clampedRadius, rect.y + rect.h}, color, {1, 1}}; // BR
-  vertices[vertexCount++] = SDL_Vertex{
-      {rect.x + clampedRadius, rect.y + rect.h}, color, {0, 1}}; // BL
-
-  indices[indexCount++] = 2;
-  indices[indexCount++] = vertexCount - 2; // BR
-  indices[indexCount++] = vertexCount - 1; // BL
-  indices[indexCount++] = 3;
-  indices[indexCount++] = 2;
-  indices[indexCount++] = vertexCount - 1; // BL
-  // Left edge
-  vertices[vertexCount++] = SDL_Vertex{
-      {rect.x, rect.y + rect.h - clampedRadius}, color, {0, 1}}; // LB
-  vertices[vertexCount++] =
-      SDL_Vertex{{rect.x, rect.y + clampedRadius}, color, {0, 0}}; // LT
-
-  indices[indexCount++] = 3;
-  indices[indexCount++] = vertexCount - 2; // LB
-  indices[indexCount++] = vertexCount - 1; // LT
-  indices[indexCount++] = 0;
-  indices[indexCount++] = 3;
-  indices[indexCount++] = vertexCount - 1; // LT
-
-  // Render everything
-  SDL_RenderGeometry(rendererData->renderer, nullptr, vertices.data(),
-                     vertexCount, indices.data(), indexCount);
+  // Define edge rectangles, each joins two center vertices with two new ones
+  const SDL_FPoint edgePoints[8] = {
+      {rect.x + clampedRadius, rect.y},                   // top TL
+      {rect.x + rect.w - clampedRadius, rect.y},          // top TR
+      {rect.x + rect.w, rect.y + clampedRadius},          // right RT
+      {rect.x + rect.w, rect.y + rect.h - clampedRadius}, // right RB
+      {rect.x + rect.w - clampedRadius, rect.y + rect.h}, // bottom BR
+      {rect.x + clampedRadius, rect.y + rect.h},          // bottom BL
+      {rect.x, rect.y + rect.h - clampedRadius},          // left LB
+      {rect.x, rect.y + clampedRadius}};                  // left LT
+  for (int edge = 0; edge < 4; edge++) {
+    vertices.push_back(SDL_Vertex{edgePoints[edge * 2], color, {0, 0}});
+    vertices.push_back(SDL_Vertex{edgePoints[edge * 2 + 1], color, {0, 0}});
+    const int vertexCount = static_cast<int>(vertices.size());
+    const int centerStart = base + edge;
+    const int centerEnd = base + (edge + 1) % 4;
+    indices.push_back(centerStart);
+    indices.push_back(vertexCount - 2);
+    indices.push_back(vertexCount - 1);
+    indices.push_back(centerEnd);
+    indices.push_back(centerStart);
+    indices.push_back(vertexCount - 1);
+  }
 }
 
-static void SDL_Clay_RenderArc(Clay_SDL3RendererData *rendererData,
-                               const SDL_FPoint center, const float radius,
-                               const float startAngle, const float endAngle,
-                               const float thickness, const Clay_Color color) {
-  SDL_SetRenderDrawColor(rendererData->renderer, color.r, color.g, color.b,
-                         color.a);
-
-  const float radStart = startAngle * (SDL_PI_F / 180.0f);
-  const float radEnd = endAngle * (SDL_PI_F / 180.0f);
+// Queues the quarter ring between radius - thickness and radius as a triangle
+// strip. signX and signY pick the corner, e.g. -1, -1 for top-left.
+static void SDL_Clay_PushArc(Clay_SDL3RendererData *rendererData,
+                             const SDL_FPoint center, const float radius,
+                             const float signX, const float signY,
+                             const float thickness, const Clay_Color _color) {
+  SDL_Clay_UseBatchTexture(rendererData, nullptr);
+  const SDL_FColor color = SDL_Clay_ToFColor(_color);
+  std::vector<SDL_Vertex> &vertices = rendererData->batchVertices;
+  std::vector<int> &indices = rendererData->batchIndices;
+
+  const float outerX = radius * signX, outerY = radius * signY;
+  const float innerRadius = SDL_max(radius - thickness, 0.0f);
+  const float innerX = innerRadius * signX, innerY = innerRadius * signY;
 
   const int numCircleSegments = SDL_max(
       NUM_CIRCLE_SEGMENTS,
       static_cast<int>(radius * 1.5f)); // increase circle segments for larger
                                         // circles, 1.5 is arbitrary.
+  const std::vector<SDL_FPoint> &quarter =
+      SDL_Clay_GetQuarterCircle(rendererData, numCircleSegments);
+
+  const int base = static_cast<int>(vertices.size());
+  for (int i = 0; i <= numCircleSegments; i++) {
+    vertices.push_back(SDL_Vertex{{center.x + quarter[i].x * outerX,
+                                   center.y + quarter[i].y * outerY},
+                                  color,
+                                  {0, 0}});
+    vertices.push_back(SDL_Vertex{{center.x + quarter[i].x * innerX,
+                                   center.y + quarter[i].y * innerY},
+                                  color,
+                                  {0, 0}});
+  }
+  // Strip order: outer i, inner i, outer i+1, inner i+1, ...
+  for (int i = 0; i < numCircleSegments * 2; i++) {
+    indices.push_back(base + i);
+    indices.push_back(base + i + 1);
+    indices.push_back(base + i + 2);
+  }
+}
 
-  const float angleStep =
-      (radEnd - radStart) / static_cast<float>(numCircleSegments);
-  const float thicknessStep =
-      0.4f; // arbitrary value to avoid overlapping lines. Changing
-            // THICKNESS_STEP or numCircleSegments might cause artifacts.
+static uint64_t SDL_Clay_HashText(const TTF_Font *font,
+                                  const Clay_StringSlice &contents,
+                                  const Clay_Color &color) {
+  // FNV-1a over the string, then the font pointer and color
+  uint64_t hash = 14695981039346656037ull;
+  for (int32_t i = 0; i < contents.length; i++) {
+    hash ^= static_cast<uint8_t>(contents.chars[i]);
+    hash *= 1099511628211ull;
+  }
+  const uint64_t extras[2] = {
+      reinterpret_cast<uintptr_t>(font),
+      (static_cast<uint64_t>(color.r) << 24) |
+          (static_cast<uint64_t>(color.g) << 16) |
+          (static_cast<uint64_t>(color.b) << 8) |
+          static_cast<uint64_t>(color.a)};
+  for (uint64_t extra : extras) {
+    hash ^= extra;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
 
-  for (float t = thicknessStep; t < thickness - thicknessStep;
-       t += thicknessStep) {
-    std::vector<SDL_FPoint> points(numCircleSegments + 1);
-    const float clampedRadius = SDL_max(radius - t, 1.0f);
+static void SDL_Clay_EvictCachedText(Clay_SDL3RendererData *rendererData) {
+  SDL_Clay_CachedText &oldest = rendererData->textCache.back();
+  auto indexed = rendererData->textCacheIndex.find(oldest.hash);
+  if (indexed != rendererData->textCacheIndex.end() &&
+      &*indexed->second == &oldest) {
+    rendererData->textCacheIndex.erase(indexed);
+  }
+  TTF_DestroyText(oldest.text);
+  rendererData->textCache.pop_back();
+}
 
-    for (int i = 0; i <= numCircleSegments; i++) {
-      const float angle = radStart + i * angleStep;
-      points[i] =
-          SDL_FPoint{SDL_roundf(center.x + SDL_cosf(angle) * clampedRadius),
-                     SDL_roundf(center.y + SDL_sinf(angle) * clampedRadius)};
+// Destroys every cached TTF_Text. Call before closing the fonts or destroying
+// the text engine.
+static void SDL_Clay_ClearTextCache(Clay_SDL3RendererData *rendererData) {
+  while (!rendererData->textCache.empty()) {
+    SDL_Clay_EvictCachedText(rendererData);
+  }
+  rendererData->textCacheIndex.clear();
+}
+
+// Sets how many TTF_Text objects are kept between frames, evicting the least
+// recently used ones if the cache is now over budget.
+static void SDL_Clay_SetTextCacheBudget(Clay_SDL3RendererData *rendererData,
+                                        size_t budget) {
+  rendererData->textCacheBudget = budget;
+  while (rendererData->textCache.size() > budget) {
+    SDL_Clay_EvictCachedText(rendererData);
+  }
+}
+
+// Returns a TTF_Text for this font, string and color, shaping it only if it
+// was not drawn recently. A hit does not allocate.
+static TTF_Text *SDL_Clay_GetCachedText(Clay_SDL3RendererData *rendererData,
+                                        TTF_Font *font,
+                                        const Clay_TextRenderData *config) {
+  const Clay_StringSlice &contents = config->stringContents;
+  const uint64_t hash = SDL_Clay_HashText(font, contents, config->textColor);
+
+  auto indexed = rendererData->textCacheIndex.find(hash);
+  if (indexed != rendererData->textCacheIndex.end()) {
+    SDL_Clay_CachedText &cached = *indexed->second;
+    if (cached.font == font &&
+        SDL_memcmp(&cached.color, &config->textColor, sizeof(Clay_Color)) ==
+            0 &&
+        cached.contents.size() == static_cast<size_t>(contents.length) &&
+        SDL_memcmp(cached.contents.data(), contents.chars, contents.length) ==
+            0) {
+      rendererData->textCache.splice(rendererData->textCache.begin(),
+                                     rendererData->textCache, indexed->second);
+      return cached.text;
     }
-    SDL_RenderLines(rendererData->renderer, points.data(),
-                    numCircleSegments + 1);
   }
+
+  TTF_Text *text = TTF_CreateText(rendererData->textEngine, font,
+                                  contents.chars, contents.length);
+  TTF_SetTextColor(text, config->textColor.r, config->textColor.g,
+                   config->textColor.b, config->textColor.a);
+  rendererData->textCache.push_front(SDL_Clay_CachedText{
+      hash, font, config->textColor,
+      std::string(contents.chars, contents.length), text});
+  // On a hash collision the newer text takes over the index slot, the older
+  // one ages out of the list on its own
+  rendererData->textCacheIndex[hash] = rendererData->textCache.begin();
+  while (rendererData->textCache.size() > rendererData->textCacheBudget) {
+    SDL_Clay_EvictCachedText(rendererData);
+  }
+  return text;
 }
 
-static SDL_Rect currentClippingRectangle;
+// Returns the texture for an IMAGE surface, uploading it only the first time
+// or after the surface was invalidated or reallocated.
+static SDL_Texture *SDL_Clay_GetImageTexture(Clay_SDL3RendererData *rendererData,
+                                             SDL_Surface *surface) {
+  SDL_Clay_CachedImage &cached = rendererData->imageCache[surface];
+  const bool reshaped = cached.w != surface->w || cached.h != surface->h ||
+                        cached.pixels != surface->pixels ||
+                        cached.format != surface->format;
+  if (!cached.texture || reshaped ||
+      cached.uploadedVersion != cached.version) {
+    if (cached.texture) {
+      SDL_DestroyTexture(cached.texture);
+    }
+    cached.texture =
+        SDL_CreateTextureFromSurface(rendererData->renderer, surface);
+    cached.w = surface->w;
+    cached.h = surface->h;
+    cached.pixels = surface->pixels;
+    cached.format = surface->format;
+    cached.uploadedVersion = cached.version;
+  }
+  cached.lastUsedFrame = rendererData->frameIndex;
+  return cached.texture;
+}
 
-static void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData,
-                                        Clay_RenderCommandArray *rcommands) {
-  for (int i = 0; i < rcommands->length; i++) {
-    Clay_RenderCommand *rcmd = Clay_RenderCommandArray_Get(rcommands, i);
-    const Clay_BoundingBox bounding_box = rcmd->boundingBox;
-    const SDL_FRect rect = {bounding_box.x, bounding_box.y, bounding_box.width,
-                            bounding_box.height};
-
-    switch (rcmd->commandType) {
-    case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
-      Clay_RectangleRenderData *config = &rcmd->renderData.rectangle;
-      SDL_SetRenderDrawBlendMode(rendererData->renderer, SDL_BLENDMODE_BLEND);
-      SDL_SetRenderDrawColor(rendererData->renderer, config->backgroundColor.r,
-                             config->backgroundColor.g,
-                             config->backgroundColor.b,
-                             config->backgroundColor.a);
-      if (config->cornerRadius.topLeft > 0) {
-        SDL_Clay_RenderFillRoundedRect(rendererData, rect,
-                                       config->cornerRadius.topLeft,
-                                       config->backgroundColor);
-      } else {
-        SDL_RenderFillRect(rendererData->renderer, &rect);
-      }
-    } break;
-    case CLAY_RENDER_COMMAND_TYPE_TEXT: {
-      Clay_TextRenderData *config = &rcmd->renderData.text;
-      TTF_Font *font = rendererData->fonts[config->fontId];
-      TTF_Text *text = TTF_CreateText(rendererData->textEngine, font,
-                                      config->stringContents.chars,
-                                      config->stringContents.length);
-      TTF_SetTextColor(text, config->textColor.r, config->textColor.g,
-                       config->textColor.b, config->textColor.a);
-      TTF_DrawRendererText(text, rect.x, rect.y);
-      TTF_DestroyText(text);
-    } break;
-    case CLAY_RENDER_COMMAND_TYPE_BORDER: {
-      Clay_BorderRenderData *config = &rcmd->renderData.border;
-
-      const float minRadius = SDL_min(rect.w, rect.h) / 2.0f;
-      const Clay_CornerRadius clampedRadii = {
-          .topLeft = SDL_min(config->cornerRadius.topLeft, minRadius),
-          .topRight = SDL_min(config->cornerRadius.topRight, minRadius),
-          .bottomLeft = SDL_min(config->cornerRadius.bottomLeft, minRadius),
-          .bottomRight = SDL_min(config->cornerRadius.bottomRight, minRadius)};
-      // edges
-      SDL_SetRenderDrawColor(rendererData->renderer, config->color.r,
-                             config->color.g, config->color.b, config->color.a);
-      if (config->width.left > 0) {
-        const float starting_y = rect.y + clampedRadii.topLeft;
-        const float length =
-            rect.h - clampedRadii.topLeft - clampedRadii.bottomLeft;
-        SDL_FRect line = {rect.x, starting_y,
-                          static_cast<float>(config->width.left), length};
-        SDL_RenderFillRect(rendererData->renderer, &line);
-      }
-      if (config->width.right > 0) {
-        const float starting_x =
-            rect.x + rect.w - static_cast<float>(config->width.right);
-        const float starting_y = rect.y + clampedRadii.topRight;
-        const float length =
-            rect.h - clampedRadii.topRight - clampedRadii.bottomRight;
-        SDL_FRect line = {starting_x, starting_y,
-                          static_cast<float>(config->width.right), length};
-        SDL_RenderFillRect(rendererData->renderer, &line);
-      }
-      if (config->width.top > 0) {
-        const float starting_x = rect.x + clampedRadii.topLeft;
-        const float length =
-            rect.w - clampedRadii.topLeft - clampedRadii.topRight;
-        SDL_FRect line = {starting_x, rect.y, length,
-                          static_cast<float>(config->width.top)};
-        SDL_RenderFillRect(rendererData->renderer, &line);
-      }
-      if (config->width.bottom > 0) {
-        const float starting_x = rect.x + clampedRadii.bottomLeft;
-        const float starting_y =
-            rect.y + rect.h - static_cast<float>(config->width.bottom);
-        const float length =
-            rect.w - clampedRadii.bottomLeft - clampedRadii.bottomRight;
-        SDL_FRect line = {starting_x, starting_y, length,
-                          static_cast<float>(config->width.bottom)};
-        SDL_SetRenderDrawColor(rendererData->renderer, config->color.r,
-                               config->color.g, config->color.b,
-                               config->color.a);
-        SDL_RenderFillRect(rendererData->renderer, &line);
-      }
-      // corners
-      if (config->cornerRadius.topLeft > 0) {
-        const float centerX = rect.x + clampedRadii.topLeft - 1;
-        const float centerY = rect.y + clampedRadii.topLeft;
-        SDL_Clay_RenderArc(rendererData, SDL_FPoint{centerX, centerY},
-                           clampedRadii.topLeft, 180.0f, 270.0f,
-                           config->width.top, config->color);
-      }
-      if (config->cornerRadius.topRight > 0) {
-        const float centerX = rect.x + rect.w - clampedRadii.topRight - 1;
-        const float centerY = rect.y + clampedRadii.topRight;
-        SDL_Clay_RenderArc(rendererData, SDL_FPoint{centerX, centerY},
-                           clampedRadii.topRight, 270.0f, 360.0f,
-                           config->width.top, config->color);
-      }
-      if (config->cornerRadius.bottomLeft > 0) {
-        const float centerX = rect.x + clampedRadii.bottomLeft - 1;
-        const float centerY = rect.y + rect.h - clampedRadii.bottomLeft - 1;
-        SDL_Clay_RenderArc(rendererData, SDL_FPoint{centerX, centerY},
-                           clampedRadii.bottomLeft, 90.0f, 180.0f,
-                           config->width.bottom, config->color);
-      }
-      if (config->cornerRadius.bottomRight > 0) {
-        const float centerX = rect.x + rect.w - clampedRadii.bottomRight -
-                              1; // TODO: why need to -1 in all
-                                 // calculations???
-        const float centerY = rect.y + rect.h - clampedRadii.bottomRight - 1;
-        SDL_Clay_RenderArc(rendererData, SDL_FPoint{centerX, centerY},
-                           clampedRadii.bottomRight, 0.0f, 90.0f,
-                           config->width.bottom, config->color);
+// Marks a surface's pixels as changed so its texture is re-uploaded the next
+// time it is drawn.
+static void SDL_Clay_InvalidateImageTexture(Clay_SDL3RendererData *rendererData,
+                                            SDL_Surface *surface) {
+  auto cached = rendererData->imageCache.find(surface);
+  if (cached != rendererData->imageCache.end()) {
+    cached->second.version++;
+  }
+}
+
+// Destroys the texture uploaded for a surface. Call before freeing a surface
+// that was drawn, since a new surface may later reuse its address.
+static void SDL_Clay_EvictImageTexture(Clay_SDL3RendererData *rendererData,
+                                       SDL_Surface *surface) {
+  auto cached = rendererData->imageCache.find(surface);
+  if (cached != rendererData->imageCache.end()) {
+    SDL_DestroyTexture(cached->second.texture);
+    rendererData->imageCache.erase(cached);
+  }
+}
+
+// Destroys textures of images that have not been drawn in the last
+// maxIdleFrames frames.
+static void
+SDL_Clay_EvictUnusedImageTextures(Clay_SDL3RendererData *rendererData,
+                                  uint64_t maxIdleFrames) {
+  for (auto it = rendererData->imageCache.begin();
+       it != rendererData->imageCache.end();) {
+    if (rendererData->frameIndex - it->second.lastUsedFrame > maxIdleFrames) {
+      SDL_DestroyTexture(it->second.texture);
+      it = rendererData->imageCache.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// Destroys every cached image texture. Call before destroying the renderer.
+static void SDL_Clay_ClearImageCache(Clay_SDL3RendererData *rendererData) {
+  for (auto &cached : rendererData->imageCache) {
+    SDL_DestroyTexture(cached.second.texture);
+  }
+  rendererData->imageCache.clear();
+}
+
+// Copies a small surface into an atlas page. IMAGE commands whose imageData is
+// this surface are then drawn from the atlas and batch with each other. Call
+// again after editing the surface's pixels to refresh its copy. Returns false
+// if the surface is too large or could not be converted, it is then drawn on
+// its own as before.
+static bool SDL_Clay_AtlasRegisterImage(Clay_SDL3RendererData *rendererData,
+                                        SDL_Surface *surface) {
+  if (surface->w > SDL_CLAY_ATLAS_MAX_IMAGE_SIZE ||
+      surface->h > SDL_CLAY_ATLAS_MAX_IMAGE_SIZE) {
+    return false;
+  }
+  SDL_Surface *converted = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+  if (!converted) {
+    return false;
+  }
+
+  auto registered = rendererData->atlasEntries.find(surface);
+  if (registered != rendererData->atlasEntries.end() &&
+      (registered->second.source.w != surface->w ||
+       registered->second.source.h != surface->h)) {
+    // The old space stays unused until SDL_Clay_ClearAtlas
+    rendererData->atlasEntries.erase(registered);
+    registered = rendererData->atlasEntries.end();
+  }
+
+  SDL_Clay_AtlasEntry entry;
+  if (registered != rendererData->atlasEntries.end()) {
+    entry = registered->second;
+  } else {
+    Clay_AtlasRect rect;
+    size_t page = 0;
+    while (page < rendererData->atlasPages.size() &&
+           !Clay_AtlasPacker_Pack(&rendererData->atlasPages[page].packer,
+                                  surface->w, surface->h, &rect)) {
+      page++;
+    }
+    if (page == rendererData->atlasPages.size()) {
+      SDL_Clay_AtlasPage newPage = {};
+      newPage.surface = SDL_CreateSurface(SDL_CLAY_ATLAS_PAGE_SIZE,
+                                          SDL_CLAY_ATLAS_PAGE_SIZE,
+                                          SDL_PIXELFORMAT_RGBA32);
+      if (!newPage.surface) {
+        SDL_DestroySurface(converted);
+        return false;
       }
+      Clay_AtlasPacker_Init(&newPage.packer, SDL_CLAY_ATLAS_PAGE_SIZE,
+                            SDL_CLAY_ATLAS_PAGE_SIZE, 1);
+      Clay_AtlasPacker_Pack(&newPage.packer, surface->w, surface->h, &rect);
+      rendererData->atlasPages.push_back(newPage);
+    }
+    entry = SDL_Clay_AtlasEntry{page, {rect.x, rect.y, rect.width, rect.height}};
+    rendererData->atlasEntries[surface] = entry;
+  }
 
-    } break;
-    case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
-      Clay_BoundingBox boundingBox = rcmd->boundingBox;
-      currentClippingRectangle = SDL_Rect{static_cast<int>(boundingBox.x),
-                                          static_cast<int>(boundingBox.y),
-                                          static_cast<int>(boundingBox.width),
-                                          static_cast<int>(boundingBox.height)};
-      SDL_SetRenderClipRect(rendererData->renderer, &currentClippingRectangle);
-      break;
+  SDL_Clay_AtlasPage &page = rendererData->atlasPages[entry.page];
+  for (int row = 0; row < entry.source.h; row++) {
+    SDL_memcpy(static_cast<uint8_t *>(page.surface->pixels) +
+                   (entry.source.y + row) * page.surface->pitch +
+                   entry.source.x * 4,
+               static_cast<uint8_t *>(converted->pixels) +
+                   row * converted->pitch,
+               entry.source.w * 4);
+  }
+  page.dirty = true;
+  SDL_DestroySurface(converted);
+  return true;
+}
+
+// Destroys the atlas pages and forgets every registered image. Call before
+// destroying the renderer.
+static void SDL_Clay_ClearAtlas(Clay_SDL3RendererData *rendererData) {
+  SDL_Clay_FlushGeometry(rendererData);
+  rendererData->batchTexture = nullptr;
+  for (SDL_Clay_AtlasPage &page : rendererData->atlasPages) {
+    SDL_DestroySurface(page.surface);
+    if (page.texture) {
+      SDL_DestroyTexture(page.texture);
+    }
+  }
+  rendererData->atlasPages.clear();
+  rendererData->atlasEntries.clear();
+}
+
+// Uploads atlas pages changed since the last frame
+static void SDL_Clay_UploadAtlas(Clay_SDL3RendererData *rendererData) {
+  for (SDL_Clay_AtlasPage &page : rendererData->atlasPages) {
+    if (!page.dirty) {
+      continue;
     }
-    case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
-      SDL_SetRenderClipRect(rendererData->renderer, nullptr);
+    if (!page.texture) {
+      page.texture = SDL_CreateTexture(
+          rendererData->renderer, SDL_PIXELFORMAT_RGBA32,
+          SDL_TEXTUREACCESS_STATIC, SDL_CLAY_ATLAS_PAGE_SIZE,
+          SDL_CLAY_ATLAS_PAGE_SIZE);
+      SDL_SetTextureBlendMode(page.texture, SDL_BLENDMODE_BLEND);
+    }
+    SDL_UpdateTexture(page.texture, nullptr, page.surface->pixels,
+                      page.surface->pitch);
+    page.dirty = false;
+  }
+}
+
+static SDL_Rect currentClippingRectangle;
+
+static void SDL_Clay_RenderCommand(Clay_SDL3RendererData *rendererData,
+                                   Clay_RenderCommand *rcmd) {
+  const Clay_BoundingBox bounding_box = rcmd->boundingBox;
+  const SDL_FRect rect = {bounding_box.x, bounding_box.y, bounding_box.width,
+                          bounding_box.height};
+
+  switch (rcmd->commandType) {
+  case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+    Clay_RectangleRenderData *config = &rcmd->renderData.rectangle;
+    if (config->cornerRadius.topLeft > 0) {
+      SDL_Clay_PushFillRoundedRect(rendererData, rect,
+                                   config->cornerRadius.topLeft,
+                                   config->backgroundColor);
+    } else {
+      SDL_Clay_PushFillRect(rendererData, rect, config->backgroundColor);
+    }
+  } break;
+  case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+    Clay_TextRenderData *config = &rcmd->renderData.text;
+    TTF_Font *font = rendererData->fonts[config->fontId];
+    SDL_Clay_FlushGeometry(rendererData);
+    if (rendererData->textCacheBudget > 0) {
+      TTF_Text *text = SDL_Clay_GetCachedText(rendererData, font, config);
+      TTF_DrawRendererText(text, rect.x, rect.y);
       break;
     }
-    case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
-      SDL_Surface *image =
-          static_cast<SDL_Surface *>(rcmd->renderData.image.imageData);
-      SDL_Texture *texture =
-          SDL_CreateTextureFromSurface(rendererData->renderer, image);
-      const SDL_FRect dest = {rect.x, rect.y, rect.w, rect.h};
-
-      SDL_RenderTexture(rendererData->renderer, texture, nullptr, &dest);
-      SDL_DestroyTexture(texture);
+    TTF_Text *text = TTF_CreateText(rendererData->textEngine, font,
+                                    config->stringContents.chars,
+                                    config->stringContents.length);
+    TTF_SetTextColor(text, config->textColor.r, config->textColor.g,
+                     config->textColor.b, config->textColor.a);
+    TTF_DrawRendererText(text, rect.x, rect.y);
+    TTF_DestroyText(text);
+  } break;
+  case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+    Clay_BorderRenderData *config = &rcmd->renderData.border;
+
+    const float minRadius = SDL_min(rect.w, rect.h) / 2.0f;
+    const Clay_CornerRadius clampedRadii = {
+        .topLeft = SDL_min(config->cornerRadius.topLeft, minRadius),
+        .topRight = SDL_min(config->cornerRadius.topRight, minRadius),
+        .bottomLeft = SDL_min(config->cornerRadius.bottomLeft, minRadius),
+        .bottomRight = SDL_min(config->cornerRadius.bottomRight, minRadius)};
+    // edges
+    if (config->width.left > 0) {
+      const float starting_y = rect.y + clampedRadii.topLeft;
+      const float length =
+          rect.h - clampedRadii.topLeft - clampedRadii.bottomLeft;
+      SDL_FRect line = {rect.x, starting_y,
+                        static_cast<float>(config->width.left), length};
+      SDL_Clay_PushFillRect(rendererData, line, config->color);
+    }
+    if (config->width.right > 0) {
+      const float starting_x =
+          rect.x + rect.w - static_cast<float>(config->width.right);
+      const float starting_y = rect.y + clampedRadii.topRight;
+      const float length =
+          rect.h - clampedRadii.topRight - clampedRadii.bottomRight;
+      SDL_FRect line = {starting_x, starting_y,
+                        static_cast<float>(config->width.right), length};
+      SDL_Clay_PushFillRect(rendererData, line, config->color);
+    }
+    if (config->width.top > 0) {
+      const float starting_x = rect.x + clampedRadii.topLeft;
+      const float length =
+          rect.w - clampedRadii.topLeft - clampedRadii.topRight;
+      SDL_FRect line = {starting_x, rect.y, length,
+                        static_cast<float>(config->width.top)};
+      SDL_Clay_PushFillRect(rendererData, line, config->color);
+    }
+    if (config->width.bottom > 0) {
+      const float starting_x = rect.x + clampedRadii.bottomLeft;
+      const float starting_y =
+          rect.y + rect.h - static_cast<float>(config->width.bottom);
+      const float length =
+          rect.w - clampedRadii.bottomLeft - clampedRadii.bottomRight;
+      SDL_FRect line = {starting_x, starting_y, length,
+                        static_cast<float>(config->width.bottom)};
+      SDL_Clay_PushFillRect(rendererData, line, config->color);
+    }
+    // corners
+    if (config->cornerRadius.topLeft > 0) {
+      const float centerX = rect.x + clampedRadii.topLeft;
+      const float centerY = rect.y + clampedRadii.topLeft;
+      SDL_Clay_PushArc(rendererData, SDL_FPoint{centerX, centerY},
+                       clampedRadii.topLeft, -1.0f, -1.0f,
+                       config->width.top, config->color);
+    }
+    if (config->cornerRadius.topRight > 0) {
+      const float centerX = rect.x + rect.w - clampedRadii.topRight;
+      const float centerY = rect.y + clampedRadii.topRight;
+      SDL_Clay_PushArc(rendererData, SDL_FPoint{centerX, centerY},
+                       clampedRadii.topRight, 1.0f, -1.0f,
+                       config->width.top, config->color);
+    }
+    if (config->cornerRadius.bottomLeft > 0) {
+      const float centerX = rect.x + clampedRadii.bottomLeft;
+      const float centerY = rect.y + rect.h - clampedRadii.bottomLeft;
+      SDL_Clay_PushArc(rendererData, SDL_FPoint{centerX, centerY},
+                       clampedRadii.bottomLeft, -1.0f, 1.0f,
+                       config->width.bottom, config->color);
+    }
+    if (config->cornerRadius.bottomRight > 0) {
+      // Filled rings share the edges' coordinates, unlike the old per-pixel
+      // polylines which needed a -1 nudge
+      const float centerX = rect.x + rect.w - clampedRadii.bottomRight;
+      const float centerY = rect.y + rect.h - clampedRadii.bottomRight;
+      SDL_Clay_PushArc(rendererData, SDL_FPoint{centerX, centerY},
+                       clampedRadii.bottomRight, 1.0f, 1.0f,
+                       config->width.bottom, config->color);
+    }
+
+  } break;
+  case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+    SDL_Clay_FlushGeometry(rendererData);
+    Clay_BoundingBox boundingBox = rcmd->boundingBox;
+    currentClippingRectangle = SDL_Rect{static_cast<int>(boundingBox.x),
+                                        static_cast<int>(boundingBox.y),
+                                        static_cast<int>(boundingBox.width),
+                                        static_cast<int>(boundingBox.height)};
+    SDL_SetRenderClipRect(rendererData->renderer, &currentClippingRectangle);
+    break;
+  }
+  case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+    SDL_Clay_FlushGeometry(rendererData);
+    SDL_SetRenderClipRect(rendererData->renderer, nullptr);
+    break;
+  }
+  case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+    SDL_Surface *image =
+        static_cast<SDL_Surface *>(rcmd->renderData.image.imageData);
+    auto atlasEntry = rendererData->atlasEntries.find(image);
+    if (atlasEntry != rendererData->atlasEntries.end()) {
+      SDL_Clay_PushAtlasImage(
+          rendererData, rendererData->atlasPages[atlasEntry->second.page],
+          atlasEntry->second.source, rect);
       break;
     }
-    default:
-      SDL_Log("Unknown render command type: %d", rcmd->commandType);
+    SDL_Texture *texture = SDL_Clay_GetImageTexture(rendererData, image);
+    SDL_Clay_FlushGeometry(rendererData);
+    const SDL_FRect dest = {rect.x, rect.y, rect.w, rect.h};
+
+    SDL_RenderTexture(rendererData->renderer, texture, nullptr, &dest);
+    break;
+  }
+  default:
+    SDL_Log("Unknown render command type: %d", rcmd->commandType);
+  }
+}
+
+// Enables caching for elements whose userData is layer. The layer must stay
+// alive until it is unregistered.
+static void SDL_Clay_RegisterLayer(Clay_SDL3RendererData *rendererData,
+                                   const Clay_LayerConfig *layer) {
+  rendererData->layers.emplace(layer, SDL_Clay_Layer{});
+}
+
+// Destroys the texture of a layer and stops caching it
+static void SDL_Clay_UnregisterLayer(Clay_SDL3RendererData *rendererData,
+                                     const Clay_LayerConfig *layer) {
+  auto registered = rendererData->layers.find(layer);
+  if (registered != rendererData->layers.end()) {
+    if (registered->second.texture) {
+      SDL_DestroyTexture(registered->second.texture);
+    }
+    rendererData->layers.erase(registered);
+  }
+}
+
+// Destroys every layer texture. Call before destroying the renderer.
+static void SDL_Clay_ClearLayers(Clay_SDL3RendererData *rendererData) {
+  for (auto &registered : rendererData->layers) {
+    if (registered.second.texture) {
+      SDL_DestroyTexture(registered.second.texture);
+    }
+  }
+  rendererData->layers.clear();
+}
+
+// Draws the layer starting at commands[start] from its texture, redrawing the
+// texture first if the commands changed. Returns the index after the layer.
+static int SDL_Clay_DrawLayer(Clay_SDL3RendererData *rendererData,
+                              SDL_Clay_Layer &layer,
+                              Clay_RenderCommandArray *rcommands,
+                              const int start) {
+  const Clay_LayerExtent extent = Clay_Layer_Measure(rcommands, start);
+  // Only the first run of a layer in a frame is cached, a second one means a
+  // descendant with its own userData split it
+  if (extent.width <= 0 || extent.height <= 0 ||
+      extent.width > CLAY_LAYER_MAX_SIZE ||
+      extent.height > CLAY_LAYER_MAX_SIZE ||
+      layer.lastDrawnFrame == rendererData->frameIndex) {
+    for (int i = start; i < extent.end; i++) {
+      SDL_Clay_RenderCommand(rendererData, &rcommands->internalArray[i]);
+    }
+    return extent.end;
+  }
+  layer.lastDrawnFrame = rendererData->frameIndex;
+  SDL_Clay_FlushGeometry(rendererData);
+
+  if (!layer.texture || layer.w != extent.width || layer.h != extent.height) {
+    if (layer.texture) {
+      SDL_DestroyTexture(layer.texture);
+    }
+    layer.texture = SDL_CreateTexture(
+        rendererData->renderer, SDL_PIXELFORMAT_RGBA8888,
+        SDL_TEXTUREACCESS_TARGET, extent.width, extent.height);
+    if (!layer.texture) {
+      for (int i = start; i < extent.end; i++) {
+        SDL_Clay_RenderCommand(rendererData, &rcommands->internalArray[i]);
+      }
+      return extent.end;
+    }
+    // Drawing with SDL_BLENDMODE_BLEND onto transparent pixels leaves
+    // premultiplied colors behind
+    SDL_SetTextureBlendMode(layer.texture, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+    layer.w = extent.width;
+    layer.h = extent.height;
+    // Anything but the current fingerprint, so the new texture is drawn
+    layer.fingerprint = extent.fingerprint + 1;
+  }
+
+  if (layer.fingerprint != extent.fingerprint) {
+    std::vector<Clay_RenderCommand> &commands = rendererData->layerCommands;
+    commands.assign(rcommands->internalArray + start,
+                    rcommands->internalArray + extent.end);
+    for (Clay_RenderCommand &command : commands) {
+      command.boundingBox.x -= extent.x;
+      command.boundingBox.y -= extent.y;
+    }
+    SDL_Texture *previousTarget = SDL_GetRenderTarget(rendererData->renderer);
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawColor(rendererData->renderer, &r, &g, &b, &a);
+    SDL_SetRenderTarget(rendererData->renderer, layer.texture);
+    SDL_SetRenderClipRect(rendererData->renderer, nullptr);
+    SDL_SetRenderDrawColor(rendererData->renderer, 0, 0, 0, 0);
+    SDL_RenderClear(rendererData->renderer);
+    for (Clay_RenderCommand &command : commands) {
+      SDL_Clay_RenderCommand(rendererData, &command);
+    }
+    SDL_Clay_FlushGeometry(rendererData);
+    SDL_SetRenderTarget(rendererData->renderer, previousTarget);
+    SDL_SetRenderDrawColor(rendererData->renderer, r, g, b, a);
+    layer.fingerprint = extent.fingerprint;
+    rendererData->layerRedrawCount++;
+  }
+
+  const SDL_FRect dest = {extent.x, extent.y, static_cast<float>(extent.width),
+                          static_cast<float>(extent.height)};
+  SDL_RenderTexture(rendererData->renderer, layer.texture, nullptr, &dest);
+  return extent.end;
+}
+
+static void SDL_Clay_RenderClayCommands(Clay_SDL3RendererData *rendererData,
+                                        Clay_RenderCommandArray *rcommands) {
+  rendererData->frameIndex++;
+  SDL_Clay_UploadAtlas(rendererData);
+  for (int i = 0; i < rcommands->length;) {
+    Clay_RenderCommand *rcmd = Clay_RenderCommandArray_Get(rcommands, i);
+    if (rcmd->userData && !rendererData->layers.empty()) {
+      auto registered = rendererData->layers.find(rcmd->userData);
+      if (registered != rendererData->layers.end() &&
+          static_cast<const Clay_LayerConfig *>(registered->first)
+              ->cacheAsLayer) {
+        i = SDL_Clay_DrawLayer(rendererData, registered->second, rcommands, i);
+        continue;
+      }
     }
+    SDL_Clay_RenderCommand(rendererData, rcmd);
+    i++;
   }
+  SDL_Clay_FlushGeometry(rendererData);
 }
 
 static inline Clay_Dimensions SDL_MeasureText(Clay_StringSlice text,
@@ -0,0 +1,751 @@
+// CPU renderer that turns a Clay_RenderCommandArray into an RGBA8 framebuffer,
+// for headless screenshots and golden-image tests on machines without a GPU.
+//
+// Commands are binned into square tiles, then the tiles are rasterized in
+// parallel on a small thread pool. Every tile replays its commands in order,
+// so the result matches a sequential render.
+//
+// Fonts are coverage atlases of the printable ASCII range. Define
+// CLAY_SOFTWARE_FREETYPE and link FreeType to build one from a TTF with
+// Clay_Software_LoadFont, or fill a Clay_SoftwareFont from any other
+// rasterizer.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../clay.h"
+#include "../clay_atlas.h"
+
+#ifdef CLAY_SOFTWARE_FREETYPE
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#endif
+
+#if !defined(CLAY_DISABLE_SIMD) &&                                             \
+    (defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64))
+#include <emmintrin.h>
+#define CLAY_SOFTWARE_SSE2
+#elif !defined(CLAY_DISABLE_SIMD) && defined(__aarch64__)
+#include <arm_neon.h>
+#define CLAY_SOFTWARE_NEON
+#endif
+
+// Pixels are stored as R, G, B, A bytes, i.e. 0xAABBGGRR on little endian
+struct Clay_SoftwareFramebuffer {
+  uint32_t *pixels;
+  int width;
+  int height;
+};
+
+// imageData of IMAGE commands. Same pixel layout as the framebuffer, with
+// straight (not premultiplied) alpha.
+struct Clay_SoftwareImage {
+  const uint32_t *pixels;
+  int width;
+  int height;
+};
+
+struct Clay_SoftwareGlyph {
+  // Rect in the atlas
+  int x, y, width, height;
+  // From the pen position on the baseline to the glyph's top-left
+  float offsetX, offsetY;
+  float advance;
+};
+
+// Coverage atlas for characters 32..126, rasterized at pixelSize. Text with a
+// different fontSize samples it scaled.
+struct Clay_SoftwareFont {
+  int pixelSize = 0;
+  float ascent = 0;
+  float lineHeight = 0;
+  int atlasWidth = 0;
+  int atlasHeight = 0;
+  std::vector<uint8_t> atlas;
+  Clay_SoftwareGlyph glyphs[95] = {};
+};
+
+// Screen-space rect in whole pixels, x1/y1 exclusive
+struct Clay_SoftwareRect {
+  int x0, y0, x1, y1;
+};
+
+// A command that survived clipping, with the scissor it was issued under
+struct Clay_SoftwareItem {
+  uint32_t commandIndex;
+  Clay_SoftwareRect clip;
+};
+
+class Clay_SoftwareRendererData {
+public:
+  // fonts[fontId] for TEXT commands, also the userData of
+  // Clay_Software_MeasureText
+  Clay_SoftwareFont *fonts = nullptr;
+  uint32_t clearColor = 0xFF000000;
+  int tileSize = 64;
+
+  // Per-frame binning state, cleared but not freed between frames
+  std::vector<Clay_SoftwareItem> items;
+  std::vector<std::vector<uint32_t>> tileBins;
+  int tilesX = 0, tilesY = 0;
+
+  // Thread pool. The calling thread rasterizes tiles too.
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  uint64_t generation = 0;
+  int busyWorkers = 0;
+  bool quit = false;
+  std::atomic<int> nextTile{0};
+  const Clay_RenderCommandArray *commands = nullptr;
+  Clay_SoftwareFramebuffer framebuffer = {};
+
+  // threadCount includes the thread calling Clay_Software_RenderClayCommands,
+  // 0 picks one per hardware thread
+  explicit Clay_SoftwareRendererData(unsigned threadCount = 0);
+  ~Clay_SoftwareRendererData();
+  Clay_SoftwareRendererData(const Clay_SoftwareRendererData &) = delete;
+  Clay_SoftwareRendererData &
+  operator=(const Clay_SoftwareRendererData &) = delete;
+};
+
+static inline uint32_t Clay_Software_PackColor(const Clay_Color color) {
+  return static_cast<uint32_t>(color.r) |
+         (static_cast<uint32_t>(color.g) << 8) |
+         (static_cast<uint32_t>(color.b) << 16) |
+         (static_cast<uint32_t>(color.a) << 24);
+}
+
+// value / 255, rounded, for value up to 255 * 255
+static inline uint32_t Clay_Software_Div255(uint32_t value) {
+  value += 128;
+  return (value + (value >> 8)) >> 8;
+}
+
+// (x * y) / 255, rounded
+static inline uint32_t Clay_Software_Mul255(uint32_t x, uint32_t y) {
+  return Clay_Software_Div255(x * y);
+}
+
+// Blends color over *dst with the given alpha (0-255)
+static inline void Clay_Software_BlendPixel(uint32_t *dst, uint32_t color,
+                                            uint32_t alpha) {
+  if (alpha == 0) {
+    return;
+  }
+  if (alpha == 255) {
+    *dst = color | 0xFF000000;
+    return;
+  }
+  // Rounded once per channel, as the SSE2 span in Clay_Software_FillSpan is
+  const uint32_t source = color | 0xFF000000;
+  const uint32_t inverse = 255 - alpha;
+  const uint32_t d = *dst;
+  uint32_t out = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    const uint32_t channel = Clay_Software_Div255(
+        ((source >> shift) & 0xFF) * alpha + ((d >> shift) & 0xFF) * inverse);
+    out |= channel << shift;
+  }
+  *dst = out;
+}
+
+// Blends color at the given alpha over the pixels [x0, x1) of a row
+static void Clay_Software_FillSpan(uint32_t *row, int x0, int x1,
+                                   uint32_t color, uint32_t alpha) {
+  if (x0 >= x1 || alpha == 0) {
+    return;
+  }
+  int x = x0;
+  if (alpha == 255) {
+    const uint32_t opaque = color | 0xFF000000;
+#if defined(CLAY_SOFTWARE_SSE2)
+    const __m128i fill = _mm_set1_epi32(static_cast<int>(opaque));
+    for (; x + 4 <= x1; x += 4) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(row + x), fill);
+    }
+#elif defined(CLAY_SOFTWARE_NEON)
+    const uint32x4_t fill = vdupq_n_u32(opaque);
+    for (; x + 4 <= x1; x += 4) {
+      vst1q_u32(row + x, fill);
+    }
+#endif
+    for (; x < x1; x++) {
+      row[x] = opaque;
+    }
+    return;
+  }
+#if defined(CLAY_SOFTWARE_SSE2)
+  // out = (src * alpha + dst * (255 - alpha)) / 255 per 16-bit channel, with
+  // the source alpha channel taken as 255 so alpha composites the same way
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i source = _mm_unpacklo_epi8(
+      _mm_set1_epi32(static_cast<int>(color | 0xFF000000)), zero);
+  const __m128i sourceTerm = _mm_add_epi16(
+      _mm_mullo_epi16(source, _mm_set1_epi16(static_cast<short>(alpha))),
+      _mm_set1_epi16(128));
+  const __m128i inverse = _mm_set1_epi16(static_cast<short>(255 - alpha));
+  for (; x + 4 <= x1; x += 4) {
+    const __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+    __m128i low = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), inverse), sourceTerm);
+    __m128i high = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), inverse), sourceTerm);
+    low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+    high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(row + x),
+                     _mm_packus_epi16(low, high));
+  }
+#endif
+  for (; x < x1; x++) {
+    Clay_Software_BlendPixel(row + x, color, alpha);
+  }
+}
+
+static inline Clay_SoftwareRect
+Clay_Software_Intersect(const Clay_SoftwareRect &a, const Clay_SoftwareRect &b) {
+  return Clay_SoftwareRect{std::max(a.x0, b.x0), std::max(a.y0, b.y0),
+                           std::min(a.x1, b.x1), std::min(a.y1, b.y1)};
+}
+
+static inline bool Clay_Software_IsEmpty(const Clay_SoftwareRect &rect) {
+  return rect.x0 >= rect.x1 || rect.y0 >= rect.y1;
+}
+
+// Pixels whose centers fall inside the box
+static inline Clay_SoftwareRect
+Clay_Software_PixelRect(const Clay_BoundingBox &box) {
+  return Clay_SoftwareRect{static_cast<int>(std::lround(box.x)),
+                           static_cast<int>(std::lround(box.y)),
+                           static_cast<int>(std::lround(box.x + box.width)),
+                           static_cast<int>(std::lround(box.y + box.height))};
+}
+
+static void Clay_Software_FillRect(const Clay_SoftwareFramebuffer &fb,
+                                   const Clay_SoftwareRect &clip,
+                                   const Clay_BoundingBox &box,
+                                   const Clay_Color color) {
+  const Clay_SoftwareRect rect =
+      Clay_Software_Intersect(Clay_Software_PixelRect(box), clip);
+  const uint32_t packed = Clay_Software_PackColor(color);
+  for (int y = rect.y0; y < rect.y1; y++) {
+    Clay_Software_FillSpan(fb.pixels + static_cast<size_t>(y) * fb.width,
+                           rect.x0, rect.x1, packed,
+                           static_cast<uint32_t>(color.a));
+  }
+}
+
+// How far a rounded corner pushes the edge inwards at a row, 0 outside the
+// corner's vertical range
+static inline float Clay_Software_CornerInset(float radius, float distance) {
+  if (radius <= 0 || distance >= radius) {
+    return 0;
+  }
+  const float dy = radius - distance;
+  return radius - std::sqrt(std::max(radius * radius - dy * dy, 0.0f));
+}
+
+// Fills the box with rounded corners. Each row is a solid span, with the
+// fractional coverage of its end pixels as antialiasing.
+static void Clay_Software_FillRoundedRect(const Clay_SoftwareFramebuffer &fb,
+                                          const Clay_SoftwareRect &clip,
+                                          const Clay_BoundingBox &box,
+                                          Clay_CornerRadius radius,
+                                          const Clay_Color color) {
+  const float maxRadius = std::min(box.width, box.height) / 2.0f;
+  radius.topLeft = std::min(radius.topLeft, maxRadius);
+  radius.topRight = std::min(radius.topRight, maxRadius);
+  radius.bottomLeft = std::min(radius.bottomLeft, maxRadius);
+  radius.bottomRight = std::min(radius.bottomRight, maxRadius);
+
+  const Clay_SoftwareRect rows =
+      Clay_Software_Intersect(Clay_Software_PixelRect(box), clip);
+  const uint32_t packed = Clay_Software_PackColor(color);
+  for (int y = rows.y0; y < rows.y1; y++) {
+    const float centerY = y + 0.5f;
+    const float fromTop = centerY - box.y;
+    const float fromBottom = box.y + box.height - centerY;
+    const float left =
+        box.x + std::max(Clay_Software_CornerInset(radius.topLeft, fromTop),
+                         Clay_Software_CornerInset(radius.bottomLeft,
+                                                   fromBottom));
+    const float right =
+        box.x + box.width -
+        std::max(Clay_Software_CornerInset(radius.topRight, fromTop),
+                 Clay_Software_CornerInset(radius.bottomRight, fromBottom));
+    if (right <= left) {
+      continue;
+    }
+    uint32_t *row = fb.pixels + static_cast<size_t>(y) * fb.width;
+    const int solidStart = static_cast<int>(std::ceil(left));
+    const int solidEnd = static_cast<int>(std::floor(right));
+    Clay_Software_FillSpan(row, std::max(solidStart, clip.x0),
+                           std::min(solidEnd, clip.x1), packed, color.a);
+    const int leftEdge = solidStart - 1;
+    if (leftEdge >= clip.x0 && leftEdge < clip.x1 && leftEdge < solidEnd) {
+      const float coverage = solidStart - left;
+      Clay_Software_BlendPixel(row + leftEdge, packed,
+                               static_cast<uint32_t>(coverage * color.a));
+    }
+    if (solidEnd >= clip.x0 && solidEnd < clip.x1 && solidEnd >= solidStart) {
+      const float coverage = right - solidEnd;
+      Clay_Software_BlendPixel(row + solidEnd, packed,
+                               static_cast<uint32_t>(coverage * color.a));
+    }
+  }
+}
+
+// Fills the part of a ring between innerRadius and outerRadius that lies in
+// region, with per-pixel antialiasing
+static void Clay_Software_FillRing(const Clay_SoftwareFramebuffer &fb,
+                                   const Clay_SoftwareRect &region,
+                                   float centerX, float centerY,
+                                   float outerRadius, float innerRadius,
+                                   const Clay_Color color) {
+  const uint32_t packed = Clay_Software_PackColor(color);
+  for (int y = region.y0; y < region.y1; y++) {
+    uint32_t *row = fb.pixels + static_cast<size_t>(y) * fb.width;
+    const float dy = y + 0.5f - centerY;
+    for (int x = region.x0; x < region.x1; x++) {
+      const float dx = x + 0.5f - centerX;
+      const float distance = std::sqrt(dx * dx + dy * dy);
+      float coverage = std::clamp(outerRadius - distance + 0.5f, 0.0f, 1.0f);
+      if (innerRadius > 0) {
+        coverage *= std::clamp(distance - innerRadius + 0.5f, 0.0f, 1.0f);
+      }
+      Clay_Software_BlendPixel(row + x, packed,
+                               static_cast<uint32_t>(coverage * color.a));
+    }
+  }
+}
+
+// Same edge and corner split as the SDL3 renderer: straight edges between the
+// corners, and quarter rings using the top or bottom width
+static void Clay_Software_DrawBorder(const Clay_SoftwareFramebuffer &fb,
+                                     const Clay_SoftwareRect &clip,
+                                     const Clay_BoundingBox &box,
+                                     const Clay_BorderRenderData &config) {
+  const float maxRadius = std::min(box.width, box.height) / 2.0f;
+  const Clay_CornerRadius radii = {
+      std::min(config.cornerRadius.topLeft, maxRadius),
+      std::min(config.cornerRadius.topRight, maxRadius),
+      std::min(config.cornerRadius.bottomLeft, maxRadius),
+      std::min(config.cornerRadius.bottomRight, maxRadius)};
+  const float top = config.width.top, bottom = config.width.bottom;
+  const float left = config.width.left, right = config.width.right;
+
+  if (left > 0) {
+    Clay_Software_FillRect(
+        fb, clip,
+        {box.x, box.y + radii.topLeft, left,
+         box.height - radii.topLeft - radii.bottomLeft},
+        config.color);
+  }
+  if (right > 0) {
+    Clay_Software_FillRect(
+        fb, clip,
+        {box.x + box.width - right, box.y + radii.topRight, right,
+         box.height - radii.topRight - radii.bottomRight},
+        config.color);
+  }
+  if (top > 0) {
+    Clay_Software_FillRect(
+        fb, clip,
+        {box.x + radii.topLeft, box.y,
+         box.width - radii.topLeft - radii.topRight, top},
+        config.color);
+  }
+  if (bottom > 0) {
+    Clay_Software_FillRect(
+        fb, clip,
+        {box.x + radii.bottomLeft, box.y + box.height - bottom,
+         box.width - radii.bottomLeft - radii.bottomRight, bottom},
+        config.color);
+  }
+
+  struct Corner {
+    float radius, width, centerX, centerY;
+    Clay_BoundingBox region;
+  };
+  const Corner corners[4] = {
+      {radii.topLeft, top, box.x + radii.topLeft, box.y + radii.topLeft,
+       {box.x, box.y, radii.topLeft, radii.topLeft}},
+      {radii.topRight, top, box.x + box.width - radii.topRight,
+       box.y + radii.topRight,
+       {box.x + box.width - radii.topRight, box.y, radii.topRight,
+        radii.topRight}},
+      {radii.bottomLeft, bottom, box.x + radii.bottomLeft,
+       box.y + box.height - radii.bottomLeft,
+       {box.x, box.y + box.height - radii.bottomLeft, radii.bottomLeft,
+        radii.bottomLeft}},
+      {radii.bottomRight, bottom, box.x + box.width - radii.bottomRight,
+       box.y + box.height - radii.bottomRight,
+       {box.x + box.width - radii.bottomRight,
+        box.y + box.height - radii.bottomRight, radii.bottomRight,
+        radii.bottomRight}}};
+  for (const Corner &corner : corners) {
+    if (corner.radius <= 0 || corner.width <= 0) {
+      continue;
+    }
+    const Clay_SoftwareRect region =
+        Clay_Software_Intersect(Clay_Software_PixelRect(corner.region), clip);
+    if (!Clay_Software_IsEmpty(region)) {
+      Clay_Software_FillRing(fb, region, corner.centerX, corner.centerY,
+                             corner.radius, corner.radius - corner.width,
+                             config.color);
+    }
+  }
+}
+
+static inline const Clay_SoftwareGlyph &
+Clay_Software_GetGlyph(const Clay_SoftwareFont &font, unsigned char c) {
+  return font.glyphs[(c >= 32 && c <= 126) ? c - 32 : '?' - 32];
+}
+
+static void Clay_Software_DrawText(const Clay_SoftwareFramebuffer &fb,
+                                   const Clay_SoftwareRect &clip,
+                                   const Clay_BoundingBox &box,
+                                   const Clay_TextRenderData &config,
+                                   const Clay_SoftwareFont &font) {
+  const float scale = static_cast<float>(config.fontSize) / font.pixelSize;
+  const float inverseScale = 1.0f / scale;
+  const uint32_t packed = Clay_Software_PackColor(config.textColor);
+  const float baseline = box.y + font.ascent * scale;
+  float penX = box.x;
+
+  for (int32_t i = 0; i < config.stringContents.length; i++) {
+    const Clay_SoftwareGlyph &glyph = Clay_Software_GetGlyph(
+        font, static_cast<unsigned char>(config.stringContents.chars[i]));
+    const float glyphX = penX + glyph.offsetX * scale;
+    const float glyphY = baseline + glyph.offsetY * scale;
+    penX += glyph.advance * scale + config.letterSpacing;
+    if (glyph.width == 0 || glyphX >= clip.x1) {
+      continue;
+    }
+    const Clay_SoftwareRect dest = Clay_Software_Intersect(
+        Clay_Software_PixelRect(
+            {glyphX, glyphY, glyph.width * scale, glyph.height * scale}),
+        clip);
+    // Nearest sample of the atlas at each destination pixel center
+    for (int y = dest.y0; y < dest.y1; y++) {
+      const int sourceY = std::min(
+          static_cast<int>((y + 0.5f - glyphY) * inverseScale),
+          glyph.height - 1);
+      const uint8_t *coverage =
+          font.atlas.data() +
+          static_cast<size_t>(glyph.y + std::max(sourceY, 0)) *
+              font.atlasWidth +
+          glyph.x;
+      uint32_t *row = fb.pixels + static_cast<size_t>(y) * fb.width;
+      for (int x = dest.x0; x < dest.x1; x++) {
+        const int sourceX = std::clamp(
+            static_cast<int>((x + 0.5f - glyphX) * inverseScale), 0,
+            glyph.width - 1);
+        Clay_Software_BlendPixel(
+            row + x, packed,
+            Clay_Software_Mul255(coverage[sourceX], config.textColor.a));
+      }
+    }
+  }
+}
+
+// Nearest-sampled, stretched to the box like the SDL renderers
+static void Clay_Software_DrawImage(const Clay_SoftwareFramebuffer &fb,
+                                    const Clay_SoftwareRect &clip,
+                                    const Clay_BoundingBox &box,
+                                    const Clay_SoftwareImage &image) {
+  const Clay_SoftwareRect dest =
+      Clay_Software_Intersect(Clay_Software_PixelRect(box), clip);
+  const float scaleX = image.width / box.width;
+  const float scaleY = image.height / box.height;
+  for (int y = dest.y0; y < dest.y1; y++) {
+    const int sourceY = std::clamp(
+        static_cast<int>((y + 0.5f - box.y) * scaleY), 0, image.height - 1);
+    const uint32_t *source =
+        image.pixels + static_cast<size_t>(sourceY) * image.width;
+    uint32_t *row = fb.pixels + static_cast<size_t>(y) * fb.width;
+    for (int x = dest.x0; x < dest.x1; x++) {
+      const int sourceX = std::clamp(
+          static_cast<int>((x + 0.5f - box.x) * scaleX), 0, image.width - 1);
+      const uint32_t pixel = source[sourceX];
+      Clay_Software_BlendPixel(row + x, pixel & 0xFFFFFF, pixel >> 24);
+    }
+  }
+}
+
+// Clears one tile and replays its bin
+static void Clay_Software_RasterizeTile(Clay_SoftwareRendererData *rendererData,
+                                        int tileIndex) {
+  const Clay_SoftwareFramebuffer &fb = rendererData->framebuffer;
+  const int tileX = tileIndex % rendererData->tilesX;
+  const int tileY = tileIndex / rendererData->tilesX;
+  const Clay_SoftwareRect tile = {
+      tileX * rendererData->tileSize, tileY * rendererData->tileSize,
+      std::min((tileX + 1) * rendererData->tileSize, fb.width),
+      std::min((tileY + 1) * rendererData->tileSize, fb.height)};
+
+  for (int y = tile.y0; y < tile.y1; y++) {
+    Clay_Software_FillSpan(fb.pixels + static_cast<size_t>(y) * fb.width,
+                           tile.x0, tile.x1, rendererData->clearColor, 255);
+  }
+
+  for (uint32_t itemIndex : rendererData->tileBins[tileIndex]) {
+    const Clay_SoftwareItem &item = rendererData->items[itemIndex];
+    const Clay_SoftwareRect clip = Clay_Software_Intersect(item.clip, tile);
+    const Clay_RenderCommand *rcmd =
+        &rendererData->commands->internalArray[item.commandIndex];
+    const Clay_BoundingBox &box = rcmd->boundingBox;
+    switch (rcmd->commandType) {
+    case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+      const Clay_RectangleRenderData &config = rcmd->renderData.rectangle;
+      const Clay_CornerRadius &radius = config.cornerRadius;
+      if (radius.topLeft > 0 || radius.topRight > 0 ||
+          radius.bottomLeft > 0 || radius.bottomRight > 0) {
+        Clay_Software_FillRoundedRect(fb, clip, box, radius,
+                                      config.backgroundColor);
+      } else {
+        Clay_Software_FillRect(fb, clip, box, config.backgroundColor);
+      }
+    } break;
+    case CLAY_RENDER_COMMAND_TYPE_BORDER:
+      Clay_Software_DrawBorder(fb, clip, box, rcmd->renderData.border);
+      break;
+    case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+      const Clay_TextRenderData &config = rcmd->renderData.text;
+      if (!rendererData->fonts) {
+        break;
+      }
+      Clay_Software_DrawText(fb, clip, box, config,
+                             rendererData->fonts[config.fontId]);
+    } break;
+    case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+      if (rcmd->renderData.image.imageData) {
+        Clay_Software_DrawImage(
+            fb, clip, box,
+            *static_cast<const Clay_SoftwareImage *>(
+                rcmd->renderData.image.imageData));
+      }
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+static void Clay_Software_RasterizeTiles(Clay_SoftwareRendererData *rendererData) {
+  const int tileCount = rendererData->tilesX * rendererData->tilesY;
+  for (int tile = rendererData->nextTile.fetch_add(1); tile < tileCount;
+       tile = rendererData->nextTile.fetch_add(1)) {
+    Clay_Software_RasterizeTile(rendererData, tile);
+  }
+}
+
+inline Clay_SoftwareRendererData::Clay_SoftwareRendererData(
+    unsigned threadCount) {
+  if (threadCount == 0) {
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  for (unsigned i = 1; i < threadCount; i++) {
+    workers.emplace_back([this]() {
+      uint64_t seenGeneration = 0;
+      std::unique_lock<std::mutex> lock(mutex);
+      while (true) {
+        wake.wait(lock,
+                  [&]() { return quit || generation != seenGeneration; });
+        if (quit) {
+          return;
+        }
+        seenGeneration = generation;
+        lock.unlock();
+        Clay_Software_RasterizeTiles(this);
+        lock.lock();
+        if (--busyWorkers == 0) {
+          done.notify_one();
+        }
+      }
+    });
+  }
+}
+
+inline Clay_SoftwareRendererData::~Clay_SoftwareRendererData() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    quit = true;
+  }
+  wake.notify_all();
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+}
+
+// Renders a frame into framebuffer, which must stay valid until this returns
+static void Clay_Software_RenderClayCommands(
+    Clay_SoftwareRendererData *rendererData,
+    const Clay_RenderCommandArray *rcommands,
+    Clay_SoftwareFramebuffer framebuffer) {
+  rendererData->commands = rcommands;
+  rendererData->framebuffer = framebuffer;
+  const int tileSize = rendererData->tileSize;
+  rendererData->tilesX = (framebuffer.width + tileSize - 1) / tileSize;
+  rendererData->tilesY = (framebuffer.height + tileSize - 1) / tileSize;
+  const size_t tileCount =
+      static_cast<size_t>(rendererData->tilesX) * rendererData->tilesY;
+  if (rendererData->tileBins.size() < tileCount) {
+    rendererData->tileBins.resize(tileCount);
+  }
+  for (size_t i = 0; i < tileCount; i++) {
+    rendererData->tileBins[i].clear();
+  }
+  rendererData->items.clear();
+
+  // Bin every visible command into the tiles its clipped bounds touch
+  const Clay_SoftwareRect screen = {0, 0, framebuffer.width,
+                                    framebuffer.height};
+  Clay_SoftwareRect scissor = screen;
+  for (int32_t i = 0; i < rcommands->length; i++) {
+    const Clay_RenderCommand *rcmd = &rcommands->internalArray[i];
+    switch (rcmd->commandType) {
+    case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+      scissor = Clay_Software_Intersect(
+          Clay_Software_PixelRect(rcmd->boundingBox), screen);
+      continue;
+    case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
+      scissor = screen;
+      continue;
+    case CLAY_RENDER_COMMAND_TYPE_NONE:
+    case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+      continue;
+    default:
+      break;
+    }
+    // Expanded by a pixel so antialiased edges stay inside their tiles' bins
+    const Clay_BoundingBox &box = rcmd->boundingBox;
+    const Clay_SoftwareRect bounds = Clay_Software_Intersect(
+        Clay_SoftwareRect{static_cast<int>(std::floor(box.x)) - 1,
+                          static_cast<int>(std::floor(box.y)) - 1,
+                          static_cast<int>(std::ceil(box.x + box.width)) + 1,
+                          static_cast<int>(std::ceil(box.y + box.height)) + 1},
+        scissor);
+    if (Clay_Software_IsEmpty(bounds)) {
+      continue;
+    }
+    const uint32_t itemIndex =
+        static_cast<uint32_t>(rendererData->items.size());
+    rendererData->items.push_back(
+        Clay_SoftwareItem{static_cast<uint32_t>(i), scissor});
+    for (int tileY = bounds.y0 / tileSize; tileY <= (bounds.y1 - 1) / tileSize;
+         tileY++) {
+      for (int tileX = bounds.x0 / tileSize;
+           tileX <= (bounds.x1 - 1) / tileSize; tileX++) {
+        rendererData->tileBins[tileY * rendererData->tilesX + tileX].push_back(
+            itemIndex);
+      }
+    }
+  }
+
+  rendererData->nextTile.store(0);
+  if (!rendererData->workers.empty()) {
+    std::lock_guard<std::mutex> lock(rendererData->mutex);
+    rendererData->busyWorkers = static_cast<int>(rendererData->workers.size());
+    rendererData->generation++;
+  }
+  rendererData->wake.notify_all();
+  Clay_Software_RasterizeTiles(rendererData);
+  std::unique_lock<std::mutex> lock(rendererData->mutex);
+  rendererData->done.wait(lock,
+                          [&]() { return rendererData->busyWorkers == 0; });
+}
+
+// Measures with the same advances Clay_Software_DrawText uses. userData is
+// the Clay_SoftwareFont array.
+static inline Clay_Dimensions
+Clay_Software_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config,
+                          void *userData) {
+  const Clay_SoftwareFont &font =
+      static_cast<const Clay_SoftwareFont *>(userData)[config->fontId];
+  const float scale = static_cast<float>(config->fontSize) / font.pixelSize;
+  float width = 0;
+  for (int32_t i = 0; i < text.length; i++) {
+    width += Clay_Software_GetGlyph(font, static_cast<unsigned char>(
+                                              text.chars[i]))
+                     .advance *
+                 scale +
+             config->letterSpacing;
+  }
+  return Clay_Dimensions{width, std::ceil(font.lineHeight * scale)};
+}
+
+#ifdef CLAY_SOFTWARE_FREETYPE
+// Rasterizes characters 32..126 of a TTF at pixelSize into font's atlas.
+// Returns false if the file cannot be loaded.
+static bool Clay_Software_LoadFont(Clay_SoftwareFont *font, const char *path,
+                                   int pixelSize) {
+  FT_Library library;
+  if (FT_Init_FreeType(&library)) {
+    return false;
+  }
+  FT_Face face;
+  if (FT_New_Face(library, path, 0, &face) ||
+      FT_Set_Pixel_Sizes(face, 0, pixelSize)) {
+    FT_Done_FreeType(library);
+    return false;
+  }
+  font->pixelSize = pixelSize;
+  font->ascent = face->size->metrics.ascender / 64.0f;
+  font->lineHeight = face->size->metrics.height / 64.0f;
+
+  // Grow the atlas until every glyph fits
+  for (int atlasSize = 256;; atlasSize *= 2) {
+    Clay_AtlasPacker packer;
+    Clay_AtlasPacker_Init(&packer, atlasSize, atlasSize, 1);
+    font->atlasWidth = font->atlasHeight = atlasSize;
+    font->atlas.assign(static_cast<size_t>(atlasSize) * atlasSize, 0);
+    bool fits = true;
+    for (int c = 32; c <= 126 && fits; c++) {
+      Clay_SoftwareGlyph &glyph = font->glyphs[c - 32];
+      glyph = Clay_SoftwareGlyph{};
+      if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
+        continue;
+      }
+      const FT_GlyphSlot slot = face->glyph;
+      const FT_Bitmap &bitmap = slot->bitmap;
+      glyph.advance = slot->advance.x / 64.0f;
+      glyph.offsetX = static_cast<float>(slot->bitmap_left);
+      glyph.offsetY = -static_cast<float>(slot->bitmap_top);
+      if (bitmap.width == 0 || bitmap.rows == 0) {
+        continue;
+      }
+      Clay_AtlasRect rect;
+      if (!Clay_AtlasPacker_Pack(&packer, bitmap.width, bitmap.rows, &rect)) {
+        fits = false;
+        break;
+      }
+      glyph.x = rect.x;
+      glyph.y = rect.y;
+      glyph.width = rect.width;
+      glyph.height = rect.height;
+      for (int row = 0; row < rect.height; row++) {
+        std::memcpy(font->atlas.data() +
+                        static_cast<size_t>(rect.y + row) * atlasSize + rect.x,
+                    bitmap.buffer + row * bitmap.pitch, rect.width);
+      }
+    }
+    if (fits) {
+      break;
+    }
+  }
+
+  FT_Done_Face(face);
+  FT_Done_FreeType(library);
+  return true;
+}
+#endif
@@ -0,0 +1,698 @@
+// Shared-memory stream of render commands, for running layout in one process
+// (e.g. a sandboxed worker) and drawing or compositing in another.
+//
+// Frames are encoded into a compact binary form directly into a ring of slots
+// in shared memory, created with memfd_create (Linux) or shm_open by name.
+// Each slot is guarded by a seqlock: the writer never waits for readers, and a
+// reader that was lapped while reading notices it and drops the frame. Text is
+// not copied out of the mapping, the decoded commands point into it.
+//
+// Pointers mean nothing in another process. imageData, customData and
+// userData are carried as 64-bit values, so store handles both sides agree on
+// (texture IDs, indices) in them instead of addresses. Colors are sent as
+// RGBA8, rounded from Clay's 0-255 floats.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "../clay.h"
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "the stream needs address-free atomics in shared memory");
+
+#define CLAY_STREAM_MAGIC 0x4D41455254535943ull // "CYSTREAM"
+#define CLAY_STREAM_VERSION 1
+
+// Bits of Clay_StreamCommandHeader::flags
+#define CLAY_STREAM_FLAG_CORNER_RADIUS 0x01
+#define CLAY_STREAM_FLAG_USER_DATA 0x02
+#define CLAY_STREAM_FLAG_SCROLL_HORIZONTAL 0x04
+#define CLAY_STREAM_FLAG_SCROLL_VERTICAL 0x08
+
+// Start of the shared memory
+struct Clay_StreamHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t slotCount;
+  // Bytes of encoded frame available in each slot
+  uint32_t slotSize;
+  uint32_t slotStride;
+  // Frame number of the newest complete frame, 0 before the first
+  std::atomic<uint64_t> latestFrame;
+  // Bumped with every frame, readers sleep on it in Clay_Stream_WaitForFrame
+  std::atomic<uint32_t> frameSignal;
+  std::atomic<uint32_t> waitingReaders;
+};
+
+struct Clay_StreamSlot {
+  // Odd while the writer fills the slot, 2 * frame number once complete
+  std::atomic<uint64_t> sequence;
+  uint32_t byteLength;
+  uint32_t reserved;
+  // The encoded frame follows
+};
+
+// Every encoded command starts with these 24 bytes, followed by its type's
+// fields, then the corner radius and userData when their flags are set
+struct Clay_StreamCommandHeader {
+  uint8_t commandType;
+  uint8_t flags;
+  int16_t zIndex;
+  uint32_t id;
+  float x, y, width, height;
+};
+
+// An encoded frame is its command count, the offset of its text block, the
+// commands, then the text of every TEXT command
+struct Clay_StreamFrameHeader {
+  uint32_t commandCount;
+  uint32_t textOffset;
+};
+
+struct Clay_Stream {
+  int fd = -1;
+  uint8_t *memory = nullptr;
+  size_t size = 0;
+  Clay_StreamHeader *header = nullptr;
+  // Copied from the header when the stream is created or opened. The other
+  // process can rewrite the header, so the read side never trusts it again
+  uint32_t slotCount = 0;
+  uint32_t slotSize = 0;
+  uint32_t slotStride = 0;
+
+  // Writer side
+  uint64_t writtenFrames = 0;
+
+  // Reader side. commands is the last frame read, its text points into the
+  // mapping and stays valid while Clay_Stream_FrameIntact is true
+  std::vector<Clay_RenderCommand> commands;
+  uint64_t readFrame = 0;
+  const Clay_StreamSlot *readSlot = nullptr;
+  uint64_t readSequence = 0;
+  // Frames the writer published that this reader never saw, and frames it
+  // lost to the writer lapping it mid-read
+  uint64_t skippedFrames = 0;
+  uint64_t tornFrames = 0;
+
+  Clay_Stream() = default;
+  Clay_Stream(const Clay_Stream &) = delete;
+  Clay_Stream &operator=(const Clay_Stream &) = delete;
+};
+
+template <typename T>
+static inline void Clay_Stream_Put(uint8_t *&cursor, const T &value) {
+  memcpy(cursor, &value, sizeof(T));
+  cursor += sizeof(T);
+}
+
+// Reads one value, failing instead of reading past end
+template <typename T>
+static inline bool Clay_Stream_Get(const uint8_t *&cursor, const uint8_t *end,
+                                   T *value) {
+  if ((size_t)(end - cursor) < sizeof(T)) {
+    return false;
+  }
+  memcpy(value, cursor, sizeof(T));
+  cursor += sizeof(T);
+  return true;
+}
+
+static inline uint32_t Clay_Stream_PackColor(const Clay_Color color) {
+  auto channel = [](float value) {
+    return (uint32_t)std::clamp(std::lround(value), 0l, 255l);
+  };
+  return channel(color.r) | (channel(color.g) << 8) |
+         (channel(color.b) << 16) | (channel(color.a) << 24);
+}
+
+static inline Clay_Color Clay_Stream_UnpackColor(uint32_t color) {
+  return {(float)(color & 0xFF), (float)((color >> 8) & 0xFF),
+          (float)((color >> 16) & 0xFF), (float)(color >> 24)};
+}
+
+static inline bool
+Clay_Stream_HasCornerRadius(const Clay_CornerRadius &radius) {
+  return radius.topLeft != 0 || radius.topRight != 0 ||
+         radius.bottomLeft != 0 || radius.bottomRight != 0;
+}
+
+// Bytes of the type-specific fields, the header and optional fields excluded
+static inline uint32_t
+Clay_Stream_BodySize(Clay_RenderCommandType commandType) {
+  switch (commandType) {
+  case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+    return 4;
+  case CLAY_RENDER_COMMAND_TYPE_BORDER:
+    return 16;
+  case CLAY_RENDER_COMMAND_TYPE_TEXT:
+    return 20;
+  case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+    return 20;
+  case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+    return 12;
+  default:
+    return 0;
+  }
+}
+
+static inline const Clay_CornerRadius *
+Clay_Stream_CornerRadius(const Clay_RenderCommand &command) {
+  const Clay_RenderData &data = command.renderData;
+  switch (command.commandType) {
+  case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+    return &data.rectangle.cornerRadius;
+  case CLAY_RENDER_COMMAND_TYPE_BORDER:
+    return &data.border.cornerRadius;
+  case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+    return &data.image.cornerRadius;
+  case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+    return &data.custom.cornerRadius;
+  default:
+    return nullptr;
+  }
+}
+
+static inline uint8_t Clay_Stream_Flags(const Clay_RenderCommand &command) {
+  uint8_t flags = 0;
+  const Clay_CornerRadius *radius = Clay_Stream_CornerRadius(command);
+  if (radius && Clay_Stream_HasCornerRadius(*radius)) {
+    flags |= CLAY_STREAM_FLAG_CORNER_RADIUS;
+  }
+  if (command.userData) {
+    flags |= CLAY_STREAM_FLAG_USER_DATA;
+  }
+  if (command.commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_START ||
+      command.commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END) {
+    if (command.renderData.scroll.horizontal) {
+      flags |= CLAY_STREAM_FLAG_SCROLL_HORIZONTAL;
+    }
+    if (command.renderData.scroll.vertical) {
+      flags |= CLAY_STREAM_FLAG_SCROLL_VERTICAL;
+    }
+  }
+  return flags;
+}
+
+static inline uint32_t
+Clay_Stream_CommandSize(const Clay_RenderCommand &command, uint8_t flags) {
+  uint32_t size = sizeof(Clay_StreamCommandHeader) +
+                  Clay_Stream_BodySize(command.commandType);
+  if (flags & CLAY_STREAM_FLAG_CORNER_RADIUS) {
+    size += sizeof(Clay_CornerRadius);
+  }
+  if (flags & CLAY_STREAM_FLAG_USER_DATA) {
+    size += sizeof(uint64_t);
+  }
+  return size;
+}
+
+// Encodes commands into out. Returns the encoded size, or 0 when it needs
+// more than capacity bytes.
+static inline uint32_t
+Clay_Stream_Encode(const Clay_RenderCommandArray *commands, uint8_t *out,
+                   uint32_t capacity) {
+  // Size the command block first so the text can be written behind it in the
+  // same pass
+  uint64_t commandBytes = sizeof(Clay_StreamFrameHeader);
+  uint64_t textBytes = 0;
+  for (int32_t i = 0; i < commands->length; i++) {
+    const Clay_RenderCommand &command = commands->internalArray[i];
+    commandBytes +=
+        Clay_Stream_CommandSize(command, Clay_Stream_Flags(command));
+    if (command.commandType == CLAY_RENDER_COMMAND_TYPE_TEXT) {
+      textBytes += (uint64_t)command.renderData.text.stringContents.length;
+    }
+  }
+  if (commandBytes + textBytes > capacity) {
+    return 0;
+  }
+
+  uint8_t *cursor = out;
+  uint8_t *text = out + commandBytes;
+  Clay_Stream_Put(cursor, Clay_StreamFrameHeader{(uint32_t)commands->length,
+                                                 (uint32_t)commandBytes});
+  for (int32_t i = 0; i < commands->length; i++) {
+    const Clay_RenderCommand &command = commands->internalArray[i];
+    const Clay_RenderData &data = command.renderData;
+    const uint8_t flags = Clay_Stream_Flags(command);
+    const Clay_BoundingBox &box = command.boundingBox;
+    Clay_Stream_Put(cursor, Clay_StreamCommandHeader{
+                                (uint8_t)command.commandType, flags,
+                                command.zIndex, command.id, box.x, box.y,
+                                box.width, box.height});
+    switch (command.commandType) {
+    case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+      Clay_Stream_Put(cursor,
+                      Clay_Stream_PackColor(data.rectangle.backgroundColor));
+      break;
+    case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+      const Clay_BorderWidth &width = data.border.width;
+      const uint16_t widths[6] = {width.left,   width.right,
+                                  width.top,    width.bottom,
+                                  width.betweenChildren, 0};
+      Clay_Stream_Put(cursor, Clay_Stream_PackColor(data.border.color));
+      Clay_Stream_Put(cursor, widths);
+      break;
+    }
+    case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+      const Clay_TextRenderData &textData = data.text;
+      const uint16_t metrics[4] = {textData.fontId, textData.fontSize,
+                                   textData.letterSpacing,
+                                   textData.lineHeight};
+      const uint32_t location[2] = {
+          (uint32_t)textData.stringContents.length, (uint32_t)(text - out)};
+      Clay_Stream_Put(cursor, Clay_Stream_PackColor(textData.textColor));
+      Clay_Stream_Put(cursor, metrics);
+      Clay_Stream_Put(cursor, location);
+      memcpy(text, textData.stringContents.chars,
+             (size_t)textData.stringContents.length);
+      text += textData.stringContents.length;
+      break;
+    }
+    case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+      Clay_Stream_Put(cursor,
+                      Clay_Stream_PackColor(data.image.backgroundColor));
+      Clay_Stream_Put(cursor, data.image.sourceDimensions);
+      Clay_Stream_Put(cursor, (uint64_t)(uintptr_t)data.image.imageData);
+      break;
+    case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+      Clay_Stream_Put(cursor,
+                      Clay_Stream_PackColor(data.custom.backgroundColor));
+      Clay_Stream_Put(cursor, (uint64_t)(uintptr_t)data.custom.customData);
+      break;
+    default:
+      break;
+    }
+    if (flags & CLAY_STREAM_FLAG_CORNER_RADIUS) {
+      Clay_Stream_Put(cursor, *Clay_Stream_CornerRadius(command));
+    }
+    if (flags & CLAY_STREAM_FLAG_USER_DATA) {
+      Clay_Stream_Put(cursor, (uint64_t)(uintptr_t)command.userData);
+    }
+  }
+  return (uint32_t)(text - out);
+}
+
+// Decodes an encoded frame into commands. Text is not copied, the string
+// slices point into data. Every read is bounds checked, so a frame the writer
+// overwrote mid-read fails or decodes to garbage that the seqlock rejects,
+// but never reads outside data.
+static inline bool
+Clay_Stream_Decode(const uint8_t *data, uint32_t length,
+                   std::vector<Clay_RenderCommand> &commands) {
+  const uint8_t *cursor = data;
+  const uint8_t *end = data + length;
+  Clay_StreamFrameHeader frame;
+  if (!Clay_Stream_Get(cursor, end, &frame) || frame.textOffset > length ||
+      frame.commandCount >
+          frame.textOffset / sizeof(Clay_StreamCommandHeader)) {
+    return false;
+  }
+  const uint8_t *commandsEnd = data + frame.textOffset;
+  commands.resize(frame.commandCount);
+  for (Clay_RenderCommand &command : commands) {
+    Clay_StreamCommandHeader header;
+    uint32_t color = 0;
+    if (!Clay_Stream_Get(cursor, commandsEnd, &header) ||
+        header.commandType > CLAY_RENDER_COMMAND_TYPE_CUSTOM) {
+      return false;
+    }
+    command = {};
+    command.commandType = (Clay_RenderCommandType)header.commandType;
+    command.zIndex = header.zIndex;
+    command.id = header.id;
+    command.boundingBox = {header.x, header.y, header.width, header.height};
+    Clay_RenderData &renderData = command.renderData;
+    switch (command.commandType) {
+    case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+      if (!Clay_Stream_Get(cursor, commandsEnd, &color)) {
+        return false;
+      }
+      renderData.rectangle.backgroundColor = Clay_Stream_UnpackColor(color);
+      break;
+    case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+      uint16_t widths[6];
+      if (!Clay_Stream_Get(cursor, commandsEnd, &color) ||
+          !Clay_Stream_Get(cursor, commandsEnd, &widths)) {
+        return false;
+      }
+      renderData.border.color = Clay_Stream_UnpackColor(color);
+      renderData.border.width = {widths[0], widths[1], widths[2], widths[3],
+                                 widths[4]};
+      break;
+    }
+    case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+      uint16_t metrics[4];
+      uint32_t location[2];
+      if (!Clay_Stream_Get(cursor, commandsEnd, &color) ||
+          !Clay_Stream_Get(cursor, commandsEnd, &metrics) ||
+          !Clay_Stream_Get(cursor, commandsEnd, &location) ||
+          location[1] < frame.textOffset || location[1] > length ||
+          location[0] > length - location[1]) {
+        return false;
+      }
+      Clay_TextRenderData &textData = renderData.text;
+      const char *chars = (const char *)data + location[1];
+      textData.stringContents = {(int32_t)location[0], chars, chars};
+      textData.textColor = Clay_Stream_UnpackColor(color);
+      textData.fontId = metrics[0];
+      textData.fontSize = metrics[1];
+      textData.letterSpacing = metrics[2];
+      textData.lineHeight = metrics[3];
+      break;
+    }
+    case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+      uint64_t handle;
+      if (!Clay_Stream_Get(cursor, commandsEnd, &color) ||
+          !Clay_Stream_Get(cursor, commandsEnd,
+                           &renderData.image.sourceDimensions) ||
+          !Clay_Stream_Get(cursor, commandsEnd, &handle)) {
+        return false;
+      }
+      renderData.image.backgroundColor = Clay_Stream_UnpackColor(color);
+      renderData.image.imageData = (void *)(uintptr_t)handle;
+      break;
+    }
+    case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+      uint64_t handle;
+      if (!Clay_Stream_Get(cursor, commandsEnd, &color) ||
+          !Clay_Stream_Get(cursor, commandsEnd, &handle)) {
+        return false;
+      }
+      renderData.custom.backgroundColor = Clay_Stream_UnpackColor(color);
+      renderData.custom.customData = (void *)(uintptr_t)handle;
+      break;
+    }
+    case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+    case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
+      renderData.scroll.horizontal =
+          (header.flags & CLAY_STREAM_FLAG_SCROLL_HORIZONTAL) != 0;
+      renderData.scroll.vertical =
+          (header.flags & CLAY_STREAM_FLAG_SCROLL_VERTICAL) != 0;
+      break;
+    default:
+      break;
+    }
+    if (header.flags & CLAY_STREAM_FLAG_CORNER_RADIUS) {
+      Clay_CornerRadius *radius =
+          const_cast<Clay_CornerRadius *>(Clay_Stream_CornerRadius(command));
+      Clay_CornerRadius ignored;
+      if (!Clay_Stream_Get(cursor, commandsEnd, radius ? radius : &ignored)) {
+        return false;
+      }
+    }
+    if (header.flags & CLAY_STREAM_FLAG_USER_DATA) {
+      uint64_t userData;
+      if (!Clay_Stream_Get(cursor, commandsEnd, &userData)) {
+        return false;
+      }
+      command.userData = (void *)(uintptr_t)userData;
+    }
+  }
+  return true;
+}
+
+static inline Clay_StreamSlot *Clay_Stream_Slot(const Clay_Stream *stream,
+                                                uint64_t frame) {
+  const size_t index = (size_t)(frame % stream->slotCount);
+  return (Clay_StreamSlot *)(stream->memory + sizeof(Clay_StreamHeader) +
+                             index * stream->slotStride);
+}
+
+static inline uint8_t *Clay_Stream_SlotData(Clay_StreamSlot *slot) {
+  return (uint8_t *)slot + sizeof(Clay_StreamSlot);
+}
+
+static inline bool Clay_Stream_Map(Clay_Stream *stream, size_t size) {
+  void *memory =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, stream->fd, 0);
+  if (memory == MAP_FAILED) {
+    return false;
+  }
+  stream->memory = (uint8_t *)memory;
+  stream->size = size;
+  stream->header = (Clay_StreamHeader *)memory;
+  return true;
+}
+
+static inline void Clay_Stream_Close(Clay_Stream *stream) {
+  if (stream->memory) {
+    munmap(stream->memory, stream->size);
+  }
+  if (stream->fd >= 0) {
+    close(stream->fd);
+  }
+  stream->fd = -1;
+  stream->memory = nullptr;
+  stream->size = 0;
+  stream->header = nullptr;
+  stream->slotCount = 0;
+  stream->slotSize = 0;
+  stream->slotStride = 0;
+  stream->commands.clear();
+  stream->readFrame = 0;
+  stream->readSlot = nullptr;
+}
+
+// Creates the shared memory as the writer. With a name it is created with
+// shm_open so other processes can open it by name (shm_unlink it when done),
+// otherwise it is an anonymous memfd whose stream->fd can be inherited across
+// fork or sent over a Unix socket. slotSize is the largest encoded frame.
+static inline bool Clay_Stream_Create(Clay_Stream *stream, const char *name,
+                                      uint32_t slotCount, uint32_t slotSize) {
+  Clay_Stream_Close(stream);
+  if (slotCount < 2) {
+    return false;
+  }
+  if (name) {
+    stream->fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0600);
+  } else {
+#ifdef __linux__
+    stream->fd = memfd_create("clay_stream", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#endif
+  }
+  if (stream->fd < 0) {
+    return false;
+  }
+  // Slots start on their own cache lines so a reader polling one sequence
+  // does not share a line with the slot being written
+  const uint32_t stride =
+      (uint32_t)((sizeof(Clay_StreamSlot) + slotSize + 63) & ~(size_t)63);
+  const size_t size = sizeof(Clay_StreamHeader) + (size_t)slotCount * stride;
+  if (ftruncate(stream->fd, (off_t)size) != 0 ||
+      !Clay_Stream_Map(stream, size)) {
+    Clay_Stream_Close(stream);
+    return false;
+  }
+#ifdef __linux__
+  // A memfd can be sealed, so no process can shrink it under a reader's
+  // mapping
+  if (!name) {
+    fcntl(stream->fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+  }
+#endif
+  stream->slotCount = slotCount;
+  stream->slotSize = slotSize;
+  stream->slotStride = stride;
+  Clay_StreamHeader *header = new (stream->memory) Clay_StreamHeader();
+  header->magic = CLAY_STREAM_MAGIC;
+  header->version = CLAY_STREAM_VERSION;
+  header->slotCount = slotCount;
+  header->slotSize = slotSize;
+  header->slotStride = stride;
+  for (uint32_t i = 0; i < slotCount; i++) {
+    new (Clay_Stream_Slot(stream, i)) Clay_StreamSlot();
+  }
+  stream->writtenFrames = 0;
+  return true;
+}
+
+// Maps a stream created by another process from its file descriptor. The
+// descriptor is duplicated, the caller keeps its own.
+static inline bool Clay_Stream_OpenFd(Clay_Stream *stream, int fd) {
+  Clay_Stream_Close(stream);
+  struct stat info;
+  if (fstat(fd, &info) != 0 ||
+      (size_t)info.st_size < sizeof(Clay_StreamHeader)) {
+    return false;
+  }
+  stream->fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+  if (stream->fd < 0 || !Clay_Stream_Map(stream, (size_t)info.st_size)) {
+    Clay_Stream_Close(stream);
+    return false;
+  }
+  // Every field is read once and checked as the copy that is kept
+  const Clay_StreamHeader *header = stream->header;
+  const uint64_t magic = header->magic;
+  const uint32_t version = header->version;
+  const uint32_t slotCount = header->slotCount;
+  const uint32_t slotSize = header->slotSize;
+  const uint32_t slotStride = header->slotStride;
+  if (magic != CLAY_STREAM_MAGIC || version != CLAY_STREAM_VERSION ||
+      slotCount < 2 ||
+      sizeof(Clay_StreamHeader) + (uint64_t)slotCount * slotStride >
+          stream->size ||
+      (uint64_t)slotSize + sizeof(Clay_StreamSlot) > slotStride) {
+    Clay_Stream_Close(stream);
+    return false;
+  }
+  stream->slotCount = slotCount;
+  stream->slotSize = slotSize;
+  stream->slotStride = slotStride;
+  return true;
+}
+
+// Opens a stream created by name
+static inline bool Clay_Stream_Open(Clay_Stream *stream, const char *name) {
+  const int fd = shm_open(name, O_RDWR, 0600);
+  if (fd < 0) {
+    return false;
+  }
+  const bool opened = Clay_Stream_OpenFd(stream, fd);
+  close(fd);
+  return opened;
+}
+
+// Encodes a frame into the next slot and publishes it. Never waits for
+// readers. Returns false, and publishes nothing, when the frame does not fit
+// in a slot.
+static inline bool
+Clay_Stream_WriteFrame(Clay_Stream *stream,
+                       const Clay_RenderCommandArray *commands) {
+  Clay_StreamHeader *header = stream->header;
+  const uint64_t frame = stream->writtenFrames + 1;
+  Clay_StreamSlot *slot = Clay_Stream_Slot(stream, frame);
+  slot->sequence.store(frame * 2 - 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  const uint32_t length =
+      Clay_Stream_Encode(commands, Clay_Stream_SlotData(slot),
+                         stream->slotSize);
+  if (length == 0) {
+    // The old frame in this slot is partly overwritten, so it stays odd and
+    // readers skip it
+    return false;
+  }
+  slot->byteLength = length;
+  slot->sequence.store(frame * 2, std::memory_order_release);
+  header->latestFrame.store(frame, std::memory_order_release);
+  stream->writtenFrames = frame;
+
+  // seq_cst pairs with the reader's waitingReaders increment: either the
+  // reader sees the new signal and does not sleep, or this sees the reader
+  // and wakes it. Release and acquire alone let both loads miss
+  header->frameSignal.fetch_add(1, std::memory_order_seq_cst);
+#ifdef __linux__
+  if (header->waitingReaders.load(std::memory_order_seq_cst) > 0) {
+    syscall(SYS_futex, &header->frameSignal, FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0);
+  }
+#endif
+  return true;
+}
+
+// Decodes the newest frame if it is newer than the last one read. Returns
+// false when there is none, or when the writer overwrote it while it was
+// decoded. The result stays in stream->commands.
+static inline bool Clay_Stream_ReadLatest(Clay_Stream *stream,
+                                          Clay_RenderCommandArray *result) {
+  const uint64_t frame =
+      stream->header->latestFrame.load(std::memory_order_acquire);
+  if (frame == 0 || frame == stream->readFrame) {
+    return false;
+  }
+  const Clay_StreamSlot *slot = Clay_Stream_Slot(stream, frame);
+  const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+  bool decoded = false;
+  if (sequence == frame * 2) {
+    // Read once, the writer may change it at any time
+    const uint32_t byteLength = slot->byteLength;
+    const uint32_t length = std::min(byteLength, stream->slotSize);
+    decoded = Clay_Stream_Decode(
+        Clay_Stream_SlotData(const_cast<Clay_StreamSlot *>(slot)), length,
+        stream->commands);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (!decoded ||
+      slot->sequence.load(std::memory_order_relaxed) != sequence) {
+    stream->tornFrames++;
+    stream->readFrame = frame;
+    return false;
+  }
+  if (stream->readFrame && frame > stream->readFrame + 1) {
+    stream->skippedFrames += frame - stream->readFrame - 1;
+  }
+  stream->readFrame = frame;
+  stream->readSlot = slot;
+  stream->readSequence = sequence;
+  *result = {(int32_t)stream->commands.size(),
+             (int32_t)stream->commands.size(), stream->commands.data()};
+  return true;
+}
+
+// True while the slot of the last frame read has not been reused. The text of
+// the decoded commands is read from the mapping, so check this after drawing
+// and drop the drawn frame when it is false.
+static inline bool Clay_Stream_FrameIntact(const Clay_Stream *stream) {
+  if (!stream->readSlot) {
+    return false;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return stream->readSlot->sequence.load(std::memory_order_relaxed) ==
+         stream->readSequence;
+}
+
+// Sleeps until the writer publishes a frame newer than the last one read, or
+// timeoutMilliseconds pass. Uses a shared futex on Linux and polling
+// elsewhere. Returns true when a new frame is available.
+static inline bool Clay_Stream_WaitForFrame(Clay_Stream *stream,
+                                            int timeoutMilliseconds) {
+  Clay_StreamHeader *header = stream->header;
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (;;) {
+    const uint32_t signal =
+        header->frameSignal.load(std::memory_order_seq_cst);
+    if (header->latestFrame.load(std::memory_order_acquire) !=
+        stream->readFrame) {
+      return true;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const long elapsed = (now.tv_sec - start.tv_sec) * 1000 +
+                         (now.tv_nsec - start.tv_nsec) / 1000000;
+    if (elapsed >= timeoutMilliseconds) {
+      return false;
+    }
+#ifdef __linux__
+    const long remaining = timeoutMilliseconds - elapsed;
+    struct timespec timeout = {remaining / 1000, (remaining % 1000) * 1000000};
+    // seq_cst, see Clay_Stream_WriteFrame. FUTEX_WAIT then returns at once
+    // if frameSignal moved on since it was loaded
+    header->waitingReaders.fetch_add(1, std::memory_order_seq_cst);
+    syscall(SYS_futex, &header->frameSignal, FUTEX_WAIT, signal, &timeout,
+            nullptr, 0);
+    header->waitingReaders.fetch_sub(1, std::memory_order_acq_rel);
+#else
+    (void)signal;
+    usleep(1000);
+#endif
+  }
+}
@@ -0,0 +1,64 @@
+// Replays a capture written by ClayMan::startCapture() without a window, renderer or fonts.
+// Build with -DCLAYMAN_BUILD_TOOLS=ON, then run clayman_replay capture.bin [passes]
+// The first pass compares every frame's render commands with the captured ones byte for byte.
+// Further passes only time the layout, with Clay's caches warm, which is handy under a profiler.
+
+#include "../clayman.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+//Only used until replayCapture() installs the captured measurements
+static Clay_Dimensions unusedMeasureText(Clay_StringSlice, Clay_TextElementConfig*, void*){
+    return {0, 0};
+}
+
+int main(int argc, char** argv){
+    if(argc < 2){
+        printf("usage: clayman_replay capture.bin [passes]\n");
+        return 2;
+    }
+    const std::string path = argv[1];
+    int passes = argc > 2 ? std::atoi(argv[2]) : 1;
+    if(passes < 1){
+        passes = 1;
+    }
+
+    ClayManCaptureInfo info;
+    if(!ClayMan::readCaptureInfo(path, info)){
+        printf("%s is not a capture from this ClayMan and clay.h version\n", path.c_str());
+        return 2;
+    }
+    printf("%s: %u frames at %ux%u, render commands %s\n", path.c_str(), info.frameCount, info.width, info.height,
+        info.hasRenderCommands ? "stored" : "not stored");
+
+    //Same capacities as the captured app, so the layout runs into the same limits
+    Clay_SetMaxElementCount(info.maxElementCount);
+    Clay_SetMaxMeasureTextCacheWordCount(info.maxMeasureTextCacheWordCount);
+    Clay_SetMaxScrollContainerCount(info.maxScrollContainerCount);
+    ClayMan clayMan(info.width, info.height, unusedMeasureText, nullptr);
+
+    bool matched = true;
+    for(int pass = 0; pass < passes; pass++){
+        ClayManReplayResult result;
+        if(!clayMan.replayCapture(path, result, pass == 0)){
+            printf("\nreplay failed\n");
+            return 2;
+        }
+        printf("pass %d: %u frames, %.3f ms layout, %.3f ms/frame, %.3f ms slowest frame\n", pass + 1, result.frames,
+            result.layoutMilliseconds, result.frames ? result.layoutMilliseconds / result.frames : 0.0, result.maxFrameMilliseconds);
+        if(result.missingMeasurements){
+            printf("  %u text measurements were missing from the capture\n", result.missingMeasurements);
+        }
+        if(pass == 0 && info.hasRenderCommands){
+            if(result.mismatchedFrames){
+                printf("  %u frames differ, first at frame %lld command %d\n", result.mismatchedFrames,
+                    (long long)result.firstMismatchFrame, result.firstMismatchCommand);
+                matched = false;
+            }else{
+                printf("  render commands match\n");
+            }
+        }
+    }
+    return matched ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// Two-process demo of the shared-memory render command stream (include/stream/clay_stream.cpp).
+// The parent lays out an animated dashboard with ClayMan and publishes every frame. A forked child
+// maps the stream from the inherited memfd, stands in for the compositor and checks every frame it reads.
+// Build with -DCLAYMAN_BUILD_TOOLS=ON, then run clayman_stream_demo [frames] [fps]
+
+#include "../clayman.hpp"
+#include "../include/stream/clay_stream.cpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/wait.h>
+
+static Clay_Dimensions demoMeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void*){
+    return (Clay_Dimensions){(float)text.length * config->fontSize * 0.5f, (float)config->fontSize};
+}
+
+static void buildFrame(ClayMan& clayMan, int frame, int frames){
+    clayMan.element({
+        .layout = {.sizing = clayMan.expandXY(), .padding = clayMan.padAll(16), .childGap = 8, .layoutDirection = CLAY_TOP_TO_BOTTOM},
+        .backgroundColor = {30, 32, 40, 255}
+    }, [&](){
+        //The compositor checks this title against the frame number it reads
+        clayMan.textElement(frame > frames ? "done" : "Frame " + std::to_string(frame), {.textColor = {240, 240, 240, 255}, .fontSize = 24, .wrapMode = CLAY_TEXT_WRAP_NONE});
+        clayMan.element({.layout = {.sizing = clayMan.expandXfixedY(24)}, .backgroundColor = {60, 60, 80, 255}, .cornerRadius = CLAY_CORNER_RADIUS(6)}, [&](){
+            clayMan.element({.layout = {.sizing = clayMan.fixedSize((float)(frame % 100) * 10, 24)}, .backgroundColor = {80, 180, 120, 255}, .cornerRadius = CLAY_CORNER_RADIUS(6)});
+        });
+        for(int row = 0; row < 20; row++){
+            clayMan.element({
+                .layout = {.sizing = clayMan.expandXfixedY(24), .padding = clayMan.padX(8)},
+                .backgroundColor = {(float)(50 + (row + frame) % 20 * 5), 54, 70, 255},
+                .border = {.color = {90, 90, 110, 255}, .width = CLAY_BORDER_OUTSIDE(1)}
+            }, [&](){
+                clayMan.textElement("Row " + std::to_string(row) + " updated at frame " + std::to_string(frame - row % 7), {.textColor = {210, 210, 220, 255}, .fontSize = 16});
+            });
+        }
+    });
+}
+
+//Reads frames until the "done" frame and checks each title against its frame number
+static int runCompositor(int fd){
+    Clay_Stream stream;
+    if(!Clay_Stream_OpenFd(&stream, fd)){
+        printf("compositor: could not map the stream\n");
+        return 1;
+    }
+    uint64_t framesRead = 0, mismatches = 0, overwrittenWhileDrawing = 0;
+    double drawnArea = 0;
+    for(;;){
+        if(!Clay_Stream_WaitForFrame(&stream, 2000)){
+            printf("compositor: no frame for 2 seconds\n");
+            return 1;
+        }
+        Clay_RenderCommandArray renderCommands;
+        if(!Clay_Stream_ReadLatest(&stream, &renderCommands)){
+            continue;
+        }
+        //Stands in for drawing: walk every command and read the text in place
+        std::string title;
+        for(int32_t i = 0; i < renderCommands.length; i++){
+            const Clay_RenderCommand& command = renderCommands.internalArray[i];
+            drawnArea += command.boundingBox.width * command.boundingBox.height;
+            if(command.commandType == CLAY_RENDER_COMMAND_TYPE_TEXT && title.empty()){
+                title.assign(command.renderData.text.stringContents.chars, command.renderData.text.stringContents.length);
+            }
+        }
+        if(!Clay_Stream_FrameIntact(&stream)){
+            overwrittenWhileDrawing++;
+            continue;
+        }
+        if(title == "done"){
+            break;
+        }
+        framesRead++;
+        if(title != "Frame " + std::to_string(stream.readFrame)){
+            mismatches++;
+        }
+        if(stream.readFrame % 60 == 0){
+            printf("compositor: frame %llu, %d commands, title \"%s\"\n", (unsigned long long)stream.readFrame, renderCommands.length, title.c_str());
+        }
+    }
+    printf("compositor: read %llu frames, skipped %llu, torn %llu, overwritten while drawing %llu, title mismatches %llu, %.0f px drawn\n",
+        (unsigned long long)framesRead, (unsigned long long)stream.skippedFrames, (unsigned long long)stream.tornFrames,
+        (unsigned long long)overwrittenWhileDrawing, (unsigned long long)mismatches, drawnArea);
+    Clay_Stream_Close(&stream);
+    return mismatches == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv){
+    const int frames = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 180;
+    const int fps = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 60;
+
+    Clay_Stream stream;
+    if(!Clay_Stream_Create(&stream, nullptr, 4, 1 << 20)){
+        printf("could not create the shared memory stream\n");
+        return 1;
+    }
+
+    //The child only needs the descriptor, as a renderer process started separately would
+    pid_t child = fork();
+    if(child < 0){
+        printf("fork failed\n");
+        return 1;
+    }
+    if(child == 0){
+        const int result = runCompositor(stream.fd);
+        fflush(stdout);
+        _exit(result);
+    }
+
+    ClayMan clayMan(1280, 720, demoMeasureText, nullptr);
+    const auto frameInterval = std::chrono::microseconds(1000000 / fps);
+    auto nextFrame = std::chrono::steady_clock::now();
+    long long writeNanoseconds = 0;
+    size_t totalCommands = 0;
+    for(int frame = 1; frame <= frames + 1; frame++){
+        clayMan.updateClayState(1280, 720, 0, 0, 0, 0, 1.0f / fps, false);
+        clayMan.beginLayout();
+        buildFrame(clayMan, frame, frames);
+        Clay_RenderCommandArray renderCommands = clayMan.endLayout();
+
+        auto start = std::chrono::steady_clock::now();
+        if(!Clay_Stream_WriteFrame(&stream, &renderCommands)){
+            printf("layout: frame %d does not fit in a slot\n", frame);
+        }
+        writeNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        totalCommands += renderCommands.length;
+
+        nextFrame += frameInterval;
+        std::this_thread::sleep_until(nextFrame);
+    }
+    printf("layout: published %d frames, %.1f us per frame to encode and publish, %.0f commands per frame\n",
+        frames + 1, writeNanoseconds / 1000.0 / (frames + 1), (double)totalCommands / (frames + 1));
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    Clay_Stream_Close(&stream);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}